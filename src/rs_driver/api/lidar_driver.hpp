@@ -69,6 +69,16 @@ public:
     driver_ptr_->regPointCloudCallback(cb_get_cloud, cb_put_cloud);
   }
 
+  /**
+   * @brief Register a point cloud pool to driver, instead of the point cloud callback functions. The driver gets 
+   * free point clouds from the pool, and puts stuffed ones back into it. Take them with CloudPool::pop().
+   * @param pool The point cloud pool
+   */
+  inline void regPointCloudPool(std::shared_ptr<CloudPool<T_PointCloud>> pool)
+  {
+    driver_ptr_->regPointCloudPool(pool);
+  }
+
   /**
    * @brief Register the lidar difop packet message callback function to driver. When lidar difop packet message is
    * ready, this function will be called
@@ -88,6 +98,52 @@ public:
     driver_ptr_->regExceptionCallback(cb_excep);
   }
 
+  /**
+   * @brief Register the downsampled point cloud callback function to driver. If voxel_size > 0, the point cloud 
+   * downsampled by the voxel grid is output with it, alongside the full point cloud. If it is not registered, 
+   * the downsampled point cloud is output with the point cloud callback, instead of the full one.
+   * @param callback The callback function
+   */
+  inline void regDownsampledPointCloudCallback(const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud)
+  {
+    driver_ptr_->regDownsampledPointCloudCallback(cb_get_cloud, cb_put_cloud);
+  }
+
+  /**
+   * @brief Register the second echo point cloud callback function to driver. If dual_return_mode is 
+   * DUAL_RETURN_SPLIT, the second returns of the dual return mode are output with it, aligned point by point 
+   * with the first returns in the point cloud. Call it before init().
+   * @param callback The callback function
+   */
+  inline void regSecondEchoPointCloudCallback(const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud)
+  {
+    driver_ptr_->regSecondEchoPointCloudCallback(cb_get_cloud, cb_put_cloud);
+  }
+
+  /**
+   * @brief Register the sector callback function to driver. If sector_pkts > 0 or sector_angle > 0, parts of 
+   * the frame are output with it while the frame is being decoded, with their metadata. The full frame is still 
+   * output with the point cloud callback. Call it before init().
+   * @param callback The callback function
+   */
+  inline void regSectorCallback(const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>, const SectorInfo&)>& cb_put_sector)
+  {
+    driver_ptr_->regSectorCallback(cb_get_cloud, cb_put_sector);
+  }
+
+  /**
+   * @brief Register the pose callback function to driver, to deskew points during decoding. The callback gives
+   * the pose of the LiDAR at a timestamp, and returns false if it is not available. Call it before init().
+   * @param callback The callback function, e.g. PoseBuffer::interpolate()
+   */
+  inline void regPoseCallback(const std::function<bool(double, RSPose&)>& cb_get_pose)
+  {
+    driver_ptr_->regPoseCallback(cb_get_pose);
+  }
+
   /**
    * @brief The initialization function, used to set up parameters and instance objects,
    *        used when get packets from online lidar or pcap
@@ -147,6 +203,16 @@ public:
     return driver_ptr_->getDeviceStatus(status);
   }
 
+  /**
+   * @brief Get the expected maximum number of points per frame. It may change after DIFOP packet is received
+   * @param num The variable to store the number of points
+   * @return if the driver is initialized, return true; else return false
+   */
+  inline bool getMaxPointsPerFrame(size_t& num)
+  {
+    return driver_ptr_->getMaxPointsPerFrame(num);
+  }
+
   /**
    * @brief Stop all threads
    */
@@ -0,0 +1,708 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/driver/lidar_driver_impl.hpp>
+#include <rs_driver/msg/fused_point_cloud_msg.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+/**
+ * @brief Driver of multiple lidars, which outputs one fused point cloud per time window. Frames of all lidars are
+ * split by time windows of the same period (SPLIT_BY_TIME), and each lidar decodes its frame directly into its own
+ * slot of the fused point cloud, with its own transform_param, so points are never copied to be merged.
+ */
+template <typename T_Point>
+class MultiLidarDriver
+{
+public:
+
+  typedef FusedPointCloudT<T_Point> FusedPointCloud;
+  typedef SlicePointCloudT<T_Point> SlicePointCloud;
+
+  MultiLidarDriver();
+  ~MultiLidarDriver();
+
+  /**
+   * @brief Register the fused point cloud callback functions. A fused point cloud is gotten for each time window,
+   * and put back when all lidars have written their frames of the window into it.
+   * @param cb_get_cloud The callback function to get a free fused point cloud
+   * @param cb_put_cloud The callback function to put back a stuffed fused point cloud
+   */
+  void regPointCloudCallback(const std::function<std::shared_ptr<FusedPointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<FusedPointCloud>)>& cb_put_cloud);
+
+  /**
+   * @brief Register the exception callback function. Its first argument is the index of the lidar.
+   * @param cb_excep The callback function
+   */
+  void regExceptionCallback(const std::function<void(size_t, const Error&)>& cb_excep);
+
+  /**
+   * @brief Initialize the drivers of all lidars. split_frame_mode, split_period and ts_first_point of them are
+   * overridden.
+   * @param params The driver parameters of the lidars, each with its own transform_param
+   * @param period The period(second) of time windows
+   * @return true if all drivers are initialized
+   */
+  bool init(const std::vector<RSDriverParam>& params, double period = 0.1);
+
+  bool start();
+  void stop();
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  constexpr static size_t CYCLE_NUM = 4;
+
+  enum SlotState { SLOT_PENDING = 0, SLOT_DONE };
+
+  struct Source
+  {
+    std::shared_ptr<LidarDriverImpl<SlicePointCloud>> driver;
+    size_t offset;     // offset of its slot in the fused point cloud
+    size_t capacity;   // size of its slot
+    std::vector<T_Point> scratch; // frames not in any time window are written here, and discarded
+    std::shared_ptr<SlicePointCloud> clouds[2]; // the cloud being written, and the one being put back
+    int64_t windows[2]; // time windows of clouds. -1: scratch
+    size_t next;       // index of the cloud being written
+    bool absent;       // no MSOP packets, so it is absent from the following time windows
+  };
+
+  struct Cycle
+  {
+    int64_t window;    // -1: free
+    std::shared_ptr<FusedPointCloud> cloud;
+    std::vector<uint8_t> states; // SlotState of each lidar
+  };
+
+  // errors found under mtx_, and reported after it is unlocked
+  struct Report
+  {
+    bool cloud_null = false;
+    bool cloud_overflow = false;
+    int64_t skewed_src = -1;
+  };
+
+  std::shared_ptr<SlicePointCloud> getCloud(size_t src);
+  void putCloud(size_t src, std::shared_ptr<SlicePointCloud> cloud);
+  void runExceptionCallback(size_t src, const Error& error);
+  void bindCloud(size_t src, size_t idx, int64_t window, std::unique_lock<std::mutex>& lock, Report& report);
+  void releaseCycles(size_t src, int64_t window);
+  Cycle* findCycle(int64_t window);
+  Cycle* createCycle(size_t src, int64_t window, Report& report);
+  bool isBound(const Source& s, int64_t window);
+  void deliverCycles();
+  void putClouds();
+  void runReport(size_t src, const Report& report);
+
+  std::function<std::shared_ptr<FusedPointCloud>(void)> cb_get_cloud_;
+  std::function<void(std::shared_ptr<FusedPointCloud>)> cb_put_cloud_;
+  std::function<void(size_t, const Error&)> cb_excep_;
+
+  std::vector<Source> sources_;
+  Cycle cycles_[CYCLE_NUM];
+  std::vector<std::shared_ptr<FusedPointCloud>> free_clouds_; // gotten from the caller, but not used yet
+  std::deque<std::shared_ptr<FusedPointCloud>> stuffed_clouds_; // to be put back to the caller, in order
+  std::mutex mtx_;
+  std::mutex put_mtx_; // held while putting back stuffed_clouds_
+  double period_;
+  size_t total_points_;
+  int64_t last_window_; // the last delivered time window
+  int64_t max_window_;  // the latest time window of all lidars
+  uint32_t seq_;
+  std::string frame_id_;
+};
+
+template <typename T_Point>
+inline MultiLidarDriver<T_Point>::MultiLidarDriver()
+  : period_(0.1), total_points_(0), last_window_(-1), max_window_(-1), seq_(0)
+{
+  for (size_t i = 0; i < CYCLE_NUM; i++)
+  {
+    cycles_[i].window = -1;
+  }
+}
+
+template <typename T_Point>
+inline MultiLidarDriver<T_Point>::~MultiLidarDriver()
+{
+  stop();
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::regPointCloudCallback(
+    const std::function<std::shared_ptr<FusedPointCloud>(void)>& cb_get_cloud,
+    const std::function<void(std::shared_ptr<FusedPointCloud>)>& cb_put_cloud)
+{
+  cb_get_cloud_ = cb_get_cloud;
+  cb_put_cloud_ = cb_put_cloud;
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::regExceptionCallback(const std::function<void(size_t, const Error&)>& cb_excep)
+{
+  cb_excep_ = cb_excep;
+}
+
+template <typename T_Point>
+inline bool MultiLidarDriver<T_Point>::init(const std::vector<RSDriverParam>& params, double period)
+{
+  if ((params.size() == 0) || !cb_get_cloud_ || !cb_put_cloud_)
+  {
+    return false;
+  }
+
+  period_ = (period > 0.0) ? period : 0.1;
+  frame_id_ = params[0].frame_id;
+
+  // all sources are allocated before any driver refers to them.
+  sources_.resize(params.size());
+  for (size_t i = 0; i < sources_.size(); i++)
+  {
+    Source& s = sources_[i];
+    s.driver = std::make_shared<LidarDriverImpl<SlicePointCloud>>();
+    s.offset = 0;
+    s.capacity = 0;
+    s.clouds[0] = std::make_shared<SlicePointCloud>();
+    s.clouds[1] = std::make_shared<SlicePointCloud>();
+    s.windows[0] = -1;
+    s.windows[1] = -1;
+    s.next = 1;
+    s.absent = false;
+  }
+
+  for (size_t i = 0; i < sources_.size(); i++)
+  {
+    RSDriverParam param = params[i];
+    param.decoder_param.split_frame_mode = SplitFrameMode::SPLIT_BY_TIME;
+    param.decoder_param.split_period = period_;
+
+    // the first point is stamped with the time by which the frame is split, so it is in the time window of the
+    // frame. the last point may be past the end of the window.
+    param.decoder_param.ts_first_point = true;
+
+    Source& s = sources_[i];
+    s.driver->regPointCloudCallback(
+        std::bind(&MultiLidarDriver<T_Point>::getCloud, this, i),
+        std::bind(&MultiLidarDriver<T_Point>::putCloud, this, i, std::placeholders::_1));
+    s.driver->regExceptionCallback(
+        std::bind(&MultiLidarDriver<T_Point>::runExceptionCallback, this, i, std::placeholders::_1));
+
+    if (!s.driver->init(param))
+    {
+      RS_ERROR << "Failed to initialize the driver of lidar " << i << "." << RS_REND;
+      sources_.clear();
+      return false;
+    }
+  }
+
+  // slots of the lidars in the fused point cloud
+  total_points_ = 0;
+  for (size_t i = 0; i < sources_.size(); i++)
+  {
+    sources_[i].offset = total_points_;
+    total_points_ += sources_[i].capacity;
+  }
+
+  return true;
+}
+
+template <typename T_Point>
+inline bool MultiLidarDriver<T_Point>::start()
+{
+  for (auto& s : sources_)
+  {
+    if (!s.driver->start())
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::stop()
+{
+  for (auto& s : sources_)
+  {
+    s.driver->stop();
+  }
+}
+
+template <typename T_Point>
+inline std::shared_ptr<SlicePointCloudT<T_Point>> MultiLidarDriver<T_Point>::getCloud(size_t src)
+{
+  std::unique_lock<std::mutex> lock(mtx_);
+  Source& s = sources_[src];
+
+  if (s.capacity == 0)
+  {
+    //
+    // the slot is sized only once, usually before the DIFOP packet arrives. size it for dual return mode, 
+    // and headroom for the jitter of time windows.
+    //
+    size_t max_points = 0;
+    s.driver->getMaxPointsPerFrameAnyEcho(max_points);
+    s.capacity = max_points + max_points / 4;
+    s.scratch.resize(s.capacity);
+  }
+
+  //
+  // the driver gets the next cloud before it puts back the current one. 
+  // write it into the scratch, until the time window of the current one is known.
+  //
+  Report report;
+  s.next = 1 - s.next;
+  bindCloud(src, s.next, -1, lock, report);
+  return s.clouds[s.next];
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::putCloud(size_t src, std::shared_ptr<SlicePointCloud> cloud)
+{
+  Report report;
+
+  {
+    std::unique_lock<std::mutex> lock(mtx_);
+    Source& s = sources_[src];
+    s.absent = false;
+
+    size_t idx = (cloud == s.clouds[0]) ? 0 : 1;
+    int64_t window = (int64_t)std::floor(cloud->timestamp / period_);
+
+    Cycle* cycle = findCycle(s.windows[idx]);
+    if (cycle != nullptr)
+    {
+      // discard the frame if it is not in the time window of its slot
+      if (window == cycle->window)
+      {
+        LidarSlice& slice = cycle->cloud->sources[src];
+        slice.size = cloud->points.size();
+        slice.received = true;
+        slice.timestamp = cloud->timestamp;
+        slice.seq = cloud->seq;
+        slice.frame_id = cloud->frame_id;
+      }
+
+      cycle->states[src] = SLOT_DONE;
+    }
+    s.windows[idx] = -1;
+
+    report.cloud_overflow = (cloud->points.dropped() > 0);
+
+    if (cloud->timestamp > 0.0)
+    {
+      // the cloud being written is the next time window. the lidar will not write into earlier ones.
+      releaseCycles(src, window + 1);
+      bindCloud(src, s.next, window + 1, lock, report);
+    }
+    else
+    {
+      // the first frame has no timestamp, so the time window of the next one is unknown.
+      bindCloud(src, s.next, -1, lock, report);
+    }
+    deliverCycles();
+  }
+
+  putClouds();
+  runReport(src, report);
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::runExceptionCallback(size_t src, const Error& error)
+{
+  if (error.error_code == ERRCODE_MSOPTIMEOUT)
+  {
+    //
+    // no MSOP packets for a while, so the lidar is not writing its cloud. 
+    // don't wait for it any more.
+    //
+    Report report;
+
+    {
+      std::unique_lock<std::mutex> lock(mtx_);
+      Source& s = sources_[src];
+      if (!s.absent)
+      {
+        s.absent = true;
+        releaseCycles(src, INT64_MAX);
+        bindCloud(src, s.next, -1, lock, report);
+        deliverCycles();
+      }
+    }
+
+    putClouds();
+  }
+
+  if (cb_excep_)
+  {
+    cb_excep_(src, error);
+  }
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::bindCloud(size_t src, size_t idx, int64_t window,
+    std::unique_lock<std::mutex>& lock, Report& report)
+{
+  Source& s = sources_[src];
+
+  Cycle* cycle = nullptr;
+  if (window >= 0)
+  {
+    max_window_ = std::max(max_window_, window);
+    if (window + (int64_t)CYCLE_NUM <= max_window_)
+    {
+      // too far behind other lidars to wait for. don't let it hold up their time windows.
+      report.skewed_src = (int64_t)src;
+      releaseCycles(src, INT64_MAX);
+      window = -1;
+    }
+  }
+
+  if ((window >= 0) && (window > last_window_) && (total_points_ > 0))
+  {
+    cycle = findCycle(window);
+    if ((cycle == nullptr) && free_clouds_.empty())
+    {
+      // the caller may block for a while, so don't hold the lock. 
+      lock.unlock();
+      std::shared_ptr<FusedPointCloud> cloud = cb_get_cloud_();
+      lock.lock();
+
+      if (cloud)
+      {
+        free_clouds_.push_back(cloud);
+      }
+      else
+      {
+        report.cloud_null = true;
+      }
+
+      // other lidars may have created it, or delivered it, in the meantime.
+      cycle = (window > last_window_) ? findCycle(window) : nullptr;
+    }
+
+    if ((cycle == nullptr) && (window > last_window_) && !free_clouds_.empty())
+    {
+      cycle = createCycle(src, window, report);
+    }
+  }
+
+  SlicePointCloud& cloud = *s.clouds[idx];
+  if (cycle != nullptr)
+  {
+    // e.g. the lidar is back, after the time window was created without it.
+    cycle->states[src] = SLOT_PENDING;
+    cloud.points.bind(cycle->cloud->points.data() + s.offset, s.capacity);
+    s.windows[idx] = window;
+  }
+  else
+  {
+    // out of time windows, e.g. the first frame, or too far from other lidars. discard it.
+    cloud.points.bind(s.scratch.data(), s.scratch.size());
+    s.windows[idx] = -1;
+  }
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::releaseCycles(size_t src, int64_t window)
+{
+  for (size_t i = 0; i < CYCLE_NUM; i++)
+  {
+    Cycle& cycle = cycles_[i];
+    if ((cycle.window >= 0) && (cycle.window < window))
+    {
+      cycle.states[src] = SLOT_DONE;
+    }
+  }
+}
+
+template <typename T_Point>
+inline typename MultiLidarDriver<T_Point>::Cycle* MultiLidarDriver<T_Point>::findCycle(int64_t window)
+{
+  if (window < 0)
+  {
+    return nullptr;
+  }
+
+  for (size_t i = 0; i < CYCLE_NUM; i++)
+  {
+    if (cycles_[i].window == window)
+    {
+      return &cycles_[i];
+    }
+  }
+
+  return nullptr;
+}
+
+template <typename T_Point>
+inline bool MultiLidarDriver<T_Point>::isBound(const Source& s, int64_t window)
+{
+  return (s.windows[0] == window) || (s.windows[1] == window);
+}
+
+template <typename T_Point>
+inline typename MultiLidarDriver<T_Point>::Cycle* MultiLidarDriver<T_Point>::createCycle(size_t src, int64_t window,
+    Report& report)
+{
+  Cycle* cycle = nullptr;
+  Cycle* oldest = nullptr;
+  for (size_t i = 0; i < CYCLE_NUM; i++)
+  {
+    if (cycles_[i].window < 0)
+    {
+      cycle = &cycles_[i];
+      break;
+    }
+
+    if ((oldest == nullptr) || (cycles_[i].window < oldest->window))
+    {
+      oldest = &cycles_[i];
+    }
+  }
+
+  if (cycle == nullptr)
+  {
+    //
+    // all time windows are waiting. lidars are too far apart in time, e.g. use_lidar_clock without 
+    // time synchronization. 
+    //
+    if (window < oldest->window)
+    {
+      // this lidar is behind all of them. discard its frame.
+      report.skewed_src = (int64_t)src;
+      return nullptr;
+    }
+
+    // don't wait any more for lidars behind the oldest time window. lidars writing into it are waited for.
+    for (size_t i = 0; i < sources_.size(); i++)
+    {
+      if ((oldest->states[i] == SLOT_PENDING) && !isBound(sources_[i], oldest->window))
+      {
+        oldest->states[i] = SLOT_DONE;
+        report.skewed_src = (int64_t)i;
+      }
+    }
+
+    deliverCycles();
+    if (oldest->window >= 0)
+    {
+      return nullptr;
+    }
+
+    cycle = oldest;
+  }
+
+  std::shared_ptr<FusedPointCloud> cloud = free_clouds_.back();
+  free_clouds_.pop_back();
+
+  // allocated only if the cloud is new.
+  cloud->points.resize(total_points_);
+  cloud->sources.resize(sources_.size());
+  for (size_t i = 0; i < sources_.size(); i++)
+  {
+    cloud->sources[i] = LidarSlice();
+    cloud->sources[i].offset = sources_[i].offset;
+  }
+
+  cycle->window = window;
+  cycle->cloud = cloud;
+  cycle->states.assign(sources_.size(), SLOT_PENDING);
+
+  // absent lidars, and those already beyond the time window, will not write into it.
+  for (size_t i = 0; i < sources_.size(); i++)
+  {
+    const Source& s = sources_[i];
+    if (s.absent || (s.windows[s.next] > window))
+    {
+      cycle->states[i] = SLOT_DONE;
+    }
+  }
+
+  return cycle;
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::deliverCycles()
+{
+  while (true)
+  {
+    // the earliest time window
+    Cycle* cycle = nullptr;
+    for (size_t i = 0; i < CYCLE_NUM; i++)
+    {
+      if ((cycles_[i].window >= 0) && ((cycle == nullptr) || (cycles_[i].window < cycle->window)))
+      {
+        cycle = &cycles_[i];
+      }
+    }
+
+    if (cycle == nullptr)
+    {
+      return;
+    }
+
+    for (auto state : cycle->states)
+    {
+      if (state != SLOT_DONE)
+      {
+        return;
+      }
+    }
+
+    last_window_ = cycle->window;
+    std::shared_ptr<FusedPointCloud> out = cycle->cloud;
+    cycle->window = -1;
+    cycle->cloud.reset();
+
+    // no lidar has a frame in it, e.g. the first time window. use the cloud again.
+    bool received = false;
+    for (const auto& slice : out->sources)
+    {
+      received = received || slice.received;
+    }
+
+    if (!received)
+    {
+      free_clouds_.push_back(out);
+      continue;
+    }
+
+    // fill the rest of slots with NAN points
+    FusedPointCloud& cloud = *out;
+    for (size_t i = 0; i < sources_.size(); i++)
+    {
+      const LidarSlice& slice = cloud.sources[i];
+      for (size_t j = slice.offset + slice.size; j < slice.offset + sources_[i].capacity; j++)
+      {
+        setPointAt(cloud, j, NAN, NAN, NAN, 0, 0.0, 0);
+      }
+    }
+
+    cloud.seq = seq_++;
+    cloud.timestamp = last_window_ * period_;
+    cloud.is_dense = false;
+    cloud.height = 1;
+    cloud.width = (uint32_t)cloud.points.size();
+    cloud.frame_id = frame_id_;
+
+    stuffed_clouds_.push_back(out);
+  }
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::putClouds()
+{
+  //
+  // put back clouds out of mtx_, so a slow caller doesn't block lidars. 
+  // only one thread puts back at a time, to keep them in order.
+  //
+  while (true)
+  {
+    std::unique_lock<std::mutex> put_lock(put_mtx_, std::try_to_lock);
+    if (!put_lock.owns_lock())
+    {
+      // the owner will put back them.
+      return;
+    }
+
+    while (true)
+    {
+      std::shared_ptr<FusedPointCloud> cloud;
+
+      {
+        std::lock_guard<std::mutex> lg(mtx_);
+        if (stuffed_clouds_.empty())
+        {
+          break;
+        }
+
+        cloud = stuffed_clouds_.front();
+        stuffed_clouds_.pop_front();
+      }
+
+      cb_put_cloud_(cloud);
+    }
+
+    put_lock.unlock();
+
+    // clouds stuffed after the last check, while put_mtx_ was still held by this thread
+    std::lock_guard<std::mutex> lg(mtx_);
+    if (stuffed_clouds_.empty())
+    {
+      return;
+    }
+  }
+}
+
+template <typename T_Point>
+inline void MultiLidarDriver<T_Point>::runReport(size_t src, const Report& report)
+{
+  if (!cb_excep_)
+  {
+    return;
+  }
+
+  if (report.cloud_null)
+  {
+    LIMIT_CALL(cb_excep_(src, Error(ERRCODE_POINTCLOUDNULL)), 1);
+  }
+
+  if (report.cloud_overflow)
+  {
+    LIMIT_CALL(cb_excep_(src, Error(ERRCODE_CLOUDOVERFLOW)), 1);
+  }
+
+  if (report.skewed_src >= 0)
+  {
+    LIMIT_CALL(cb_excep_((size_t)report.skewed_src, Error(ERRCODE_LIDARSKEW)), 1);
+  }
+}
+
+}  // namespace lidar
+}  // namespace robosense
@@ -0,0 +1,261 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/driver/decoder/decoder_factory.hpp>
+#include <rs_driver/msg/span_point_cloud_msg.hpp>
+
+#include <atomic>
+#include <vector>
+
+//
+// decoders of so many calibrations are kept by each thread calling decode(). 
+// With more calibrations decoded on a thread, decoders are rebuilt, i.e. allocated, from time to time.
+//
+#ifndef RS_DECODE_SLOT_NUM
+#define RS_DECODE_SLOT_NUM 4
+#endif
+
+namespace robosense
+{
+namespace lidar
+{
+
+/**
+ * @brief Calibration of a lidar, i.e. its type, the decoder parameters and its latest DIFOP packet. It is read-only
+ * while shared by threads calling decode(). Update it before sharing it, or share a new one instead.
+ */
+class CalibrationState
+{
+public:
+
+  /**
+   * @brief Constructor. Parameters which need state across packets are reset, i.e. organized, voxel_size,
+   * sector_pkts, sector_angle, and dual_return_mode=SPLIT. Frames are split only by angle of mechanical lidars, 
+   * which needs no state across packets. Otherwise no split hint is given.
+   * @param type The lidar type
+   * @param param The decoder parameters
+   */
+  CalibrationState(LidarType type, const RSDecoderParam& param)
+    : type_(type), param_(param), id_(nextId()), splits_(true)
+  {
+    if (param_.organized || (param_.voxel_size > 0.0f))
+    {
+      RS_WARNING << "organized and voxel_size are ignored by decode(). reset them." << RS_REND;
+      param_.organized = false;
+      param_.voxel_size = 0.0f;
+    }
+
+    if ((param_.sector_pkts > 0) || (param_.sector_angle > 0.0f))
+    {
+      RS_WARNING << "sector_pkts and sector_angle are ignored by decode(). reset them." << RS_REND;
+      param_.sector_pkts = 0;
+      param_.sector_angle = 0.0f;
+    }
+
+    if (param_.dual_return_mode == DualReturnMode::DUAL_RETURN_SPLIT)
+    {
+      RS_WARNING << "dual_return_mode=SPLIT is ignored by decode(). reset it to ALL." << RS_REND;
+      param_.dual_return_mode = DualReturnMode::DUAL_RETURN_ALL;
+    }
+
+    //
+    // the others count blocks, or follow packet seqs or time, on the decoder of the calling thread. Then the split
+    // hints would depend on which packets the thread happens to have decoded before.
+    //
+    if (!isMech(type_) || (param_.split_frame_mode != SplitFrameMode::SPLIT_BY_ANGLE))
+    {
+      RS_WARNING << "decode() splits frames only by angle of mechanical lidars. no split hint is given." << RS_REND;
+      splits_ = false;
+    }
+  }
+
+  /**
+   * @brief Save the DIFOP packet, whose calibration data is applied to the following decode().
+   * @param pkt The DIFOP packet
+   * @param size The size of the packet
+   */
+  void updateDifop(const uint8_t* pkt, size_t size)
+  {
+    difop_.assign(pkt, pkt + size);
+    id_ = nextId();
+  }
+
+  LidarType type() const
+  {
+    return type_;
+  }
+
+  const RSDecoderParam& param() const
+  {
+    return param_;
+  }
+
+  const std::vector<uint8_t>& difop() const
+  {
+    return difop_;
+  }
+
+  uint64_t id() const
+  {
+    return id_;
+  }
+
+  bool splits() const
+  {
+    return splits_;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  static uint64_t nextId()
+  {
+    static std::atomic<uint64_t> next_id(0);
+    return ++next_id;
+  }
+
+  LidarType type_;
+  RSDecoderParam param_;
+  std::vector<uint8_t> difop_;
+  uint64_t id_; // unique among all calibrations and their updates
+  bool splits_; // are split hints given?
+};
+
+/**
+ * @brief Decode a MSOP packet into the point cloud provided by the caller, and tell if a new frame starts in it.
+ * No thread is started and no callback is called. The points are appended to the cloud, so it may collect the packets
+ * of a frame. The function is thread-safe.
+ *
+ * Decoders are built per thread and per calibration at the first call, and reused later, so the following calls
+ * allocate nothing. Each thread keeps the decoders of RS_DECODE_SLOT_NUM (4 by default) calibrations. 
+ * Splitting by angle is done within the packet, with the previous block assumed to be one block before its first
+ * one. The other split modes need state across packets, so no split hint is given for them. See CalibrationState.
+ *
+ * @param pkt The MSOP packet
+ * @param size The size of the packet
+ * @param calib The calibration of the lidar
+ * @param out The point cloud. Its split hints and error code are set.
+ * @return true if a new frame starts in the packet
+ */
+inline bool decode(const uint8_t* pkt, size_t size, const CalibrationState& calib, OutputSpan& out)
+{
+  struct DecoderSlot
+  {
+    uint64_t id = 0;
+    std::shared_ptr<Decoder<OutputSpan>> decoder;
+    OutputSpan* out = nullptr;
+  };
+
+  constexpr static size_t SLOT_NUM = RS_DECODE_SLOT_NUM;
+  thread_local DecoderSlot slots[SLOT_NUM];
+  thread_local size_t next_slot = 0;
+
+  DecoderSlot* slot = nullptr;
+  for (size_t i = 0; i < SLOT_NUM; i++)
+  {
+    if (slots[i].decoder && (slots[i].id == calib.id()))
+    {
+      slot = &slots[i];
+      break;
+    }
+  }
+
+  out.split = false;
+  out.split_index = 0;
+  out.error = ERRCODE_SUCCESS;
+
+  if (slot == nullptr)
+  {
+    slot = &slots[next_slot];
+    next_slot = (next_slot + 1) % SLOT_NUM;
+
+    slot->id = calib.id();
+    slot->out = &out;
+    slot->decoder = DecoderFactory<OutputSpan>::createDecoder(calib.type(), calib.param());
+    bool splits = calib.splits();
+    slot->decoder->regCallback(
+        [slot](const Error& err)
+        {
+          if (slot->out != nullptr)
+          {
+            slot->out->error = err.error_code;
+          }
+        },
+        [slot, splits](uint16_t, double)
+        {
+          if (splits && !slot->out->split)
+          {
+            slot->out->split = true;
+            slot->out->split_index = slot->out->size();
+          }
+        });
+
+    const std::vector<uint8_t>& difop = calib.difop();
+    if (difop.size() > 0)
+    {
+      slot->decoder->processDifopPkt(difop.data(), difop.size());
+    }
+
+    slot->out = nullptr;
+  }
+
+  ErrCode err = slot->decoder->checkMsopPkt(pkt, size);
+  if (err != ERRCODE_SUCCESS)
+  {
+    out.error = err;
+    return false;
+  }
+
+  // alias the caller's cloud, without owning or allocating anything
+  slot->out = &out;
+  slot->decoder->point_cloud_ = std::shared_ptr<OutputSpan>(std::shared_ptr<OutputSpan>(), &out);
+  slot->decoder->resetSplitStrategy();
+
+  slot->decoder->decodeMsopPkt(pkt, size);
+
+  slot->decoder->point_cloud_.reset();
+  slot->out = nullptr;
+
+  if ((out.error == ERRCODE_SUCCESS) && out.overflow())
+  {
+    out.error = ERRCODE_CLOUDOVERFLOW;
+  }
+
+  return out.split;
+}
+
+}  // namespace lidar
+}  // namespace robosense
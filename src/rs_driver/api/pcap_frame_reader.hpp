@@ -0,0 +1,316 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#ifndef DISABLE_PCAP_PARSE
+
+#include <rs_driver/driver/decoder/decoder_factory.hpp>
+#include <rs_driver/driver/input/input_pcap.hpp>
+#include <rs_driver/driver/input/input_pcap_jumbo.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+/**
+ * @brief Read a PCAP file frame by frame, on the caller's thread. Packets are read, decoded and split as fast as
+ * possible, without threads, queues or sleeping, and no frame is dropped. The last frame is output at the end of file,
+ * even if it is not complete.
+ *
+ * @code
+ * PcapFrameReader<PointCloudMsg> reader("lidar.pcap", param);
+ * PointCloudMsg cloud;
+ * while (reader.next(cloud))
+ * {
+ *   // process cloud
+ * }
+ * @endcode
+ */
+template <typename T_PointCloud>
+class PcapFrameReader
+{
+public:
+
+  /**
+   * @brief Constructor
+   * @param pcap_path The PCAP file. It overrides param.input_param.pcap_path.
+   * @param param The driver parameters. input_type and pcap_repeat are ignored, and use_lidar_clock is forced to
+   * true, since packets are read faster than real time, and the host time doesn't tell when they were captured.
+   */
+  PcapFrameReader(const std::string& pcap_path, const RSDriverParam& param);
+
+  /**
+   * @brief Register the exception callback function. It is called on the caller's thread, inside next().
+   * @param cb_excep The callback function
+   */
+  void regExceptionCallback(const std::function<void(const Error&)>& cb_excep)
+  {
+    cb_excep_ = cb_excep;
+  }
+
+  /**
+   * @brief Read packets until a frame is split, and swap it into cloud.
+   * @param cloud The point cloud. Its previous buffers are reused for the following frames.
+   * @return false at the end of file, or if the file cannot be opened
+   */
+  bool next(T_PointCloud& cloud);
+
+  /**
+   * @brief Get the DIFOP packet related information, after the first frame
+   */
+  bool getDeviceInfo(DeviceInfo& info)
+  {
+    return (decoder_ptr_ ? decoder_ptr_->getDeviceInfo(info) : false);
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  bool init();
+  void runExceptionCallback(const Error& error);
+  std::shared_ptr<Buffer> packetGet(size_t size);
+  void packetPut(std::shared_ptr<Buffer> pkt, bool stuffed);
+  void splitFrame(uint16_t height, double ts);
+  void setPointCloudHeader(T_PointCloud& msg, uint16_t height, double ts);
+
+  RSDriverParam driver_param_;
+  std::function<void(const Error&)> cb_excep_;
+  std::shared_ptr<Decoder<T_PointCloud>> decoder_ptr_;
+  std::shared_ptr<Input> input_ptr_;
+  std::shared_ptr<Buffer> pkt_; // reused for every packet
+  std::deque<std::shared_ptr<T_PointCloud>> ready_clouds_; // split frames, not taken by next() yet
+  std::vector<std::shared_ptr<T_PointCloud>> free_clouds_; // clouds to reuse for the following frames
+  uint32_t point_cloud_seq_;
+  bool ds_instead_; // output the downsampled point cloud instead of the full one
+  bool init_flag_;
+  bool end_flag_;
+};
+
+template <typename T_PointCloud>
+inline PcapFrameReader<T_PointCloud>::PcapFrameReader(const std::string& pcap_path, const RSDriverParam& param)
+  : driver_param_(param), point_cloud_seq_(0), ds_instead_(false), init_flag_(false), end_flag_(false)
+{
+  driver_param_.input_type = InputType::PCAP_FILE;
+  driver_param_.input_param.pcap_path = pcap_path;
+  driver_param_.input_param.pcap_repeat = false;
+
+  if (!driver_param_.decoder_param.use_lidar_clock)
+  {
+    RS_WARNING << "PcapFrameReader reads packets faster than real time. use_lidar_clock is forced to true." << RS_REND;
+    driver_param_.decoder_param.use_lidar_clock = true;
+  }
+}
+
+template <typename T_PointCloud>
+inline bool PcapFrameReader<T_PointCloud>::init()
+{
+  if (init_flag_)
+  {
+    return true;
+  }
+
+  const RSDriverParam& param = driver_param_;
+
+  //
+  // decoder
+  //
+  decoder_ptr_ = DecoderFactory<T_PointCloud>::createDecoder(param.lidar_type, param.decoder_param);
+
+  ds_instead_ = (param.decoder_param.voxel_size > 0.0f) && !RS_HAS_MEMBER(T_PointCloud, distances);
+  decoder_ptr_->point_cloud_ = std::make_shared<T_PointCloud>();
+  reservePoints(*decoder_ptr_->point_cloud_, ds_instead_ ? 0 : decoder_ptr_->getMaxPointsPerFrame());
+
+  decoder_ptr_->regCallback(
+      std::bind(&PcapFrameReader<T_PointCloud>::runExceptionCallback, this, std::placeholders::_1),
+      std::bind(&PcapFrameReader<T_PointCloud>::splitFrame, this, std::placeholders::_1, std::placeholders::_2));
+
+  //
+  // input. It is read by readPacket(), and never started.
+  //
+  if (isJumbo(param.lidar_type))
+  {
+    input_ptr_ = std::make_shared<InputPcapJumbo>(param.input_param, 0.0);
+    pkt_ = std::make_shared<Buffer>(IP_LEN);
+  }
+  else
+  {
+    input_ptr_ = std::make_shared<InputPcap>(param.input_param, 0.0);
+    pkt_ = std::make_shared<Buffer>(ETH_LEN);
+  }
+
+  input_ptr_->regCallback(
+      std::bind(&PcapFrameReader<T_PointCloud>::runExceptionCallback, this, std::placeholders::_1),
+      std::bind(&PcapFrameReader<T_PointCloud>::packetGet, this, std::placeholders::_1),
+      std::bind(&PcapFrameReader<T_PointCloud>::packetPut, this, std::placeholders::_1, std::placeholders::_2));
+
+  if (!input_ptr_->init())
+  {
+    input_ptr_.reset();
+    decoder_ptr_.reset();
+    end_flag_ = true;
+    return false;
+  }
+
+  init_flag_ = true;
+  return true;
+}
+
+template <typename T_PointCloud>
+inline bool PcapFrameReader<T_PointCloud>::next(T_PointCloud& cloud)
+{
+  if (!init_flag_ && (end_flag_ || !init()))
+  {
+    return false;
+  }
+
+  while (ready_clouds_.empty())
+  {
+    if (end_flag_)
+    {
+      return false;
+    }
+
+    if (!input_ptr_->readPacket())  // reach file end.
+    {
+      end_flag_ = true;
+      runExceptionCallback(Error(ERRCODE_PCAPEXIT));
+
+      // the last frame, not split by the decoder
+      if ((pointNum(*decoder_ptr_->point_cloud_) > 0) || ds_instead_)
+      {
+        decoder_ptr_->flushFrame();
+      }
+    }
+  }
+
+  std::shared_ptr<T_PointCloud> ready = ready_clouds_.front();
+  ready_clouds_.pop_front();
+
+  std::swap(cloud, *ready);
+  free_clouds_.push_back(ready);
+  return true;
+}
+
+template <typename T_PointCloud>
+inline void PcapFrameReader<T_PointCloud>::runExceptionCallback(const Error& error)
+{
+  if (cb_excep_)
+  {
+    cb_excep_(error);
+  }
+}
+
+template <typename T_PointCloud>
+inline std::shared_ptr<Buffer> PcapFrameReader<T_PointCloud>::packetGet(size_t)
+{
+  return pkt_;
+}
+
+template <typename T_PointCloud>
+inline void PcapFrameReader<T_PointCloud>::packetPut(std::shared_ptr<Buffer> pkt, bool)
+{
+  static const uint8_t msop_id[] = {0x55, 0xAA};
+  static const uint8_t difop_id[] = {0xA5, 0xFF};
+
+  uint8_t* id = pkt->data();
+  if (memcmp(id, msop_id, sizeof(msop_id)) == 0)
+  {
+    decoder_ptr_->processMsopPkt(pkt->data(), pkt->dataSize());
+  }
+  else if (memcmp(id, difop_id, sizeof(difop_id)) == 0)
+  {
+    decoder_ptr_->processDifopPkt(pkt->data(), pkt->dataSize());
+  }
+}
+
+template <typename T_PointCloud>
+inline void PcapFrameReader<T_PointCloud>::splitFrame(uint16_t height, double ts)
+{
+  std::shared_ptr<T_PointCloud> cloud = decoder_ptr_->point_cloud_;
+  if (pointNum(*cloud) == 0)
+  {
+    runExceptionCallback(Error(ERRCODE_ZEROPOINTS));
+    return;
+  }
+
+  setPointCloudHeader(*cloud, height, ts);
+  ready_clouds_.push_back(cloud);
+
+  // reuse a cloud taken by next(), or allocate one if frames are split faster than they are taken.
+  std::shared_ptr<T_PointCloud> next;
+  if (free_clouds_.empty())
+  {
+    next = std::make_shared<T_PointCloud>();
+  }
+  else
+  {
+    next = free_clouds_.back();
+    free_clouds_.pop_back();
+  }
+
+  clearPoints(*next);
+  reservePoints(*next, ds_instead_ ? 0 : decoder_ptr_->getMaxPointsPerFrame());
+  decoder_ptr_->point_cloud_ = next;
+}
+
+template <typename T_PointCloud>
+inline void PcapFrameReader<T_PointCloud>::setPointCloudHeader(T_PointCloud& msg, uint16_t height, double ts)
+{
+  msg.seq = point_cloud_seq_++;
+  msg.timestamp = ts;
+  msg.is_dense = (driver_param_.decoder_param.dense_points || ds_instead_) &&
+    !RS_HAS_MEMBER(T_PointCloud, col_timestamps);
+  if (msg.is_dense)
+  {
+    msg.height = 1;
+    msg.width = (uint32_t)pointNum(msg);
+  }
+  else
+  {
+    msg.height = height;
+    msg.width = (uint32_t)pointNum(msg) / msg.height;
+  }
+
+  msg.frame_id = driver_param_.frame_id;
+}
+
+}  // namespace lidar
+}  // namespace robosense
+
+#endif
@@ -66,6 +66,8 @@ enum ErrCode
   ERRCODE_PKTBUFOVERFLOW  = 0x48,  ///< Packet queue is overflow
   ERRCODE_CLOUDOVERFLOW   = 0x49,  ///< Point cloud buffer is overflow
   ERRCODE_WRONGCRC32      = 0x4A,  ///< Wrong CRC32 value of MSOP Packet
+  ERRCODE_NOPOSE          = 0x4B,  ///< Pose for deskewing points is not available
+  ERRCODE_LIDARSKEW       = 0x4C,  ///< Lidars are too far apart in time to be fused
 
   // error
   ERRCODE_STARTBEFOREINIT = 0x80,  ///< User calls start() before init()
@@ -132,6 +134,10 @@ struct Error
         return "ERRCODE_CLOUDOVERFLOW";
       case ERRCODE_WRONGCRC32:
         return "ERRCODE_WRONGCRC32";
+      case ERRCODE_NOPOSE:
+        return "ERRCODE_NOPOSE";
+      case ERRCODE_LIDARSKEW:
+        return "ERRCODE_LIDARSKEW";
 
       // error
       case ERRCODE_STARTBEFOREINIT:
@@ -33,21 +33,24 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #pragma once
 
 #include <rs_driver/common/error_code.hpp>
+#include <rs_driver/msg/sector_msg.hpp>
 #include <rs_driver/driver/driver_param.hpp>
 #include <rs_driver/driver/decoder/member_checker.hpp>
 #include <rs_driver/driver/decoder/trigon.hpp>
 #include <rs_driver/driver/decoder/section.hpp>
 #include <rs_driver/driver/decoder/basic_attr.hpp>
+#include <rs_driver/driver/decoder/transform.hpp>
+#include <rs_driver/driver/decoder/point_batch.hpp>
+#include <rs_driver/driver/decoder/deskew.hpp>
+#include <rs_driver/driver/decoder/voxel_grid.hpp>
+#include <rs_driver/driver/decoder/roi_filter.hpp>
+#include <rs_driver/driver/decoder/dual_return.hpp>
 
 #ifndef _USE_MATH_DEFINES
 #define _USE_MATH_DEFINES // for VC++, required to use const M_IP in <math.h>
 #endif
-#define ENABLE_TRANSFORM 1
-#ifdef ENABLE_TRANSFORM
-// Eigen lib
-#include <Eigen/Dense>
-#endif
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <memory>
@@ -248,16 +251,15 @@ class Decoder
 {
 public:
 
-#ifdef ENABLE_TRANSFORM
-  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
-#endif
-
   virtual void decodeDifopPkt(const uint8_t* pkt, size_t size) = 0;
   virtual bool decodeMsopPkt(const uint8_t* pkt, size_t size) = 0;
   virtual ~Decoder() = default;
 
   void processDifopPkt(const uint8_t* pkt, size_t size);
   bool processMsopPkt(const uint8_t* pkt, size_t size);
+  ErrCode checkMsopPkt(const uint8_t* pkt, size_t size);
+  virtual void resetSplitStrategy() {} // forget previous packets, so that the next one is split on its own
+  void flushFrame(); // split the accumulated points as a frame, e.g. at the end of input
 
   explicit Decoder(const RSDecoderConstParam& const_param, const RSDecoderParam& param);
 
@@ -265,6 +267,8 @@ public:
   bool getDeviceInfo(DeviceInfo& info);
   bool getDeviceStatus(DeviceStatus& status);
   double getPacketDuration();
+  virtual size_t getMaxPointsPerFrame();
+  virtual size_t getMaxPointsPerFrameAnyEcho();
   void enableWritePktTs(bool value);
   double prevPktTs();
   void transformPoint(float& x, float& y, float& z);
@@ -272,30 +276,102 @@ public:
   void regCallback(
       const std::function<void(const Error&)>& cb_excep,
       const std::function<void(uint16_t, double)>& cb_split_frame);
+  void regPoseCallback(const std::function<bool(double, RSPose&)>& cb_get_pose);
+  void regSectorCallback(const std::function<void(size_t, size_t, double, const SectorInfo&)>& cb_put_sector);
 
   std::shared_ptr<T_PointCloud> point_cloud_; // accumulated point cloud currently
+  std::shared_ptr<T_PointCloud> voxel_cloud_; // downsampled point cloud, output alongside point_cloud_ if not null
+  std::shared_ptr<T_PointCloud> echo_cloud_; // second returns in dual return mode, if dual_return_mode=SPLIT
 
 #ifndef UNIT_TEST
 protected:
 #endif
 
+  // range image and polar cloud are built on distances, and need no xyz
+  constexpr static bool XYZ = !RS_HAS_MEMBER(T_PointCloud, distances);
+
+  enum { CLOUD_POINTS, CLOUD_POLAR, CLOUD_RANGE_IMAGE };
+  constexpr static int CLOUD_KIND = RS_HAS_MEMBER(T_PointCloud, col_timestamps) ? CLOUD_RANGE_IMAGE : 
+    (RS_HAS_MEMBER(T_PointCloud, distances) ? CLOUD_POLAR : CLOUD_POINTS);
+
+  // points save timestamp offsets to the timestamp of point cloud, which is then the first point's.
+  constexpr static bool TS_OFFSET = (CLOUD_KIND == CLOUD_POINTS) && (RS_POINT_HAS_MEMBER(T_PointCloud, ts_offset) || 
+      RS_POINT_HAS_MEMBER(T_PointCloud, ts_offset_ns) || RS_HAS_MEMBER(T_PointCloud, ts_offsets));
+
   double cloudTs();
+  void pushPoint(float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring,
+      float distance = 0.0f, int32_t azimuth = PointBatch::ANGLE_UNKNOWN, 
+      int32_t elevation = PointBatch::ANGLE_UNKNOWN);
+  void pushNanPoint(double timestamp, uint16_t ring);
+  void writePoint(float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring);
+  void bindDirect();
+  void flushBatch();
+  void flushBatch(std::integral_constant<int, CLOUD_POINTS> kind);
+  void flushBatch(std::integral_constant<int, CLOUD_POLAR> kind);
+  void flushBatch(std::integral_constant<int, CLOUD_RANGE_IMAGE> kind);
+  template <int KIND>
+  void bindFlushBatch(std::integral_constant<int, KIND> kind) {} // others have no flush_points_
+  void bindFlushBatch(std::integral_constant<int, CLOUD_POINTS> kind);
+  template <bool DENSE, bool TRANSFORM>
+  void flushBatchImpl();
+  template <bool TRANSFORM>
+  void flushBatchOrganized();
+  void flushBatchRangeImage();
+  uint32_t expectedWidth();
+  uint32_t grownWidth(uint32_t width, uint32_t cols);
+  uint32_t growOrganized(uint32_t width, uint32_t new_width);
+  void growRangeImage(uint32_t width, uint32_t new_width);
+  void deskewBatch();
+  void trackSector();
+  void putSector(bool last);
+  template <bool DENSE>
+  void flushBatchPolar();
+  void splitFrame(uint16_t height, double ts);
 
   RSDecoderConstParam const_param_; // const param
   RSDecoderParam param_; // user param
   std::function<void(uint16_t, double)> cb_split_frame_;
   std::function<void(const Error&)> cb_excep_;
+  std::function<bool(double, RSPose&)> cb_get_pose_;
+  std::function<void(size_t, size_t, double, const SectorInfo&)> cb_put_sector_;
   bool write_pkt_ts_;
 
-#ifdef ENABLE_TRANSFORM
-  Eigen::Matrix4d trans_;
+  Transform transform_; // transform applied to points of each batch
+  PointBatch batch_; // points of current packet, not written into point_cloud_ yet
+  PointBatch echo_batch_; // second returns of current packet, not written into echo_cloud_ yet
+  void (Decoder::*flush_points_)(); // flushBatchImpl()/flushBatchOrganized() specialized for the params
+  bool direct_; // write points into point_cloud_ directly, instead of batch_, if flushBatch() would only copy them
+  Deskew deskew_; // motion compensation applied to points of each batch, if pose callback is registered
+  double deskew_ref_ts_; // reference time of deskew_, i.e. the first point of current frame
+  bool deskew_ref_ok_; // is the reference pose available?
+  bool deskew_nopose_; // has ERRCODE_NOPOSE been reported for current frame?
+  VoxelGrid voxel_grid_; // voxel-grid downsampling of points, if voxel_size > 0
+  RoiFilter roi_; // crop boxes applied to points of each batch. the decoders test the ring/azimuth mask per channel
+  DualReturnFilter dual_return_; // selection of returns applied to points of each batch, in dual return mode
+  bool new_frame_; // is the next batch the start of a frame?
+  uint32_t frame_pts_; // points (including NAN ones) of current frame, in organized mode or range image
+  uint32_t frame_width_; // expected columns of current frame, in organized mode or range image
+  double frame_ts_base_; // timestamp of the first point of current frame
+  size_t sector_start_; // first point of current sector in point_cloud_
+  uint16_t sector_pkts_; // packets of current sector
+  uint16_t sector_index_; // index of current sector in the frame
+  int32_t sector_az_start_; // azimuth of the first point of current sector, ANGLE_UNKNOWN if no one yet
+  int32_t sector_az_end_; // azimuth of the last point of current sector
+  double sector_ts_start_; // timestamp of the first point of current sector
+  double sector_ts_end_; // timestamp of the last point of current sector
+  float rx_; // offset of the optical center, saved into polar cloud
+  float rz_; // offset of the optical center, saved into polar cloud
+
+#ifdef ENABLE_COMPACT_TRIGON
+  const TrigonCompact& trigon_; // shared by all decoders
+#else
+  const Trigon& trigon_; // shared by all decoders
 #endif
-
-  Trigon trigon_;
 #define SIN(angle) this->trigon_.sin(angle)
 #define COS(angle) this->trigon_.cos(angle)
 
   double packet_duration_;
+  uint32_t pkts_per_frame_; // msop packets per frame, used by lidars which split frames by packet
   DistanceSection distance_section_; // invalid section of distance
 
   RSEchoMode echo_mode_; // echo mode (defined by return mode)
@@ -318,12 +394,64 @@ inline void Decoder<T_PointCloud>::regCallback(
   cb_split_frame_ = cb_split_frame;
 }
 
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::regPoseCallback(const std::function<bool(double, RSPose&)>& cb_get_pose)
+{
+  cb_get_pose_ = cb_get_pose;
+  bindDirect();
+
+  if (cb_get_pose_ && !param_.ts_first_point)
+  {
+    RS_WARNING << "points are deskewed to the first point of the frame."
+               << " ts_first_point is ignored." << RS_REND;
+  }
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::regSectorCallback(
+    const std::function<void(size_t, size_t, double, const SectorInfo&)>& cb_put_sector)
+{
+  if ((param_.sector_pkts > 0) || (param_.sector_angle > 0.0f))
+  {
+    cb_put_sector_ = cb_put_sector;
+    bindDirect();
+  }
+}
+
 template <typename T_PointCloud>
 inline Decoder<T_PointCloud>::Decoder(const RSDecoderConstParam& const_param, const RSDecoderParam& param)
   : const_param_(const_param)
   , param_(param)
   , write_pkt_ts_(false)
+  , transform_(param.transform_param)
+  , flush_points_(nullptr)
+  , direct_(false)
+  , deskew_ref_ts_(-1.0)
+  , deskew_ref_ok_(false)
+  , deskew_nopose_(false)
+  , voxel_grid_(param.voxel_size, param.voxel_centroid)
+  , roi_(param.crop_boxes, param.ring_azimuth_mask)
+  , dual_return_(param.dual_return_mode, param.dual_return_tolerance)
+  , new_frame_(true)
+  , frame_pts_(0)
+  , frame_width_(0)
+  , frame_ts_base_(0.0)
+  , sector_start_(0)
+  , sector_pkts_(0)
+  , sector_index_(0)
+  , sector_az_start_(PointBatch::ANGLE_UNKNOWN)
+  , sector_az_end_(PointBatch::ANGLE_UNKNOWN)
+  , sector_ts_start_(-1.0)
+  , sector_ts_end_(0.0)
+  , rx_(0.0f)
+  , rz_(0.0f)
+#ifdef ENABLE_COMPACT_TRIGON
+  , trigon_(TrigonCompact::instance())
+#else
+  , trigon_(Trigon::instance())
+#endif
   , packet_duration_(0)
+  , pkts_per_frame_(0)
   , distance_section_(const_param.DISTANCE_MIN, const_param.DISTANCE_MAX, param.min_distance, param.max_distance)
   , echo_mode_(ECHO_SINGLE)
   , temperature_(0.0)
@@ -332,14 +460,146 @@ inline Decoder<T_PointCloud>::Decoder(const RSDecoderConstParam& const_param, co
   , prev_point_ts_(0.0)
   , first_point_ts_(0.0)
 {
-#ifdef ENABLE_TRANSFORM
-  Eigen::AngleAxisd current_rotation_x(param_.transform_param.roll, Eigen::Vector3d::UnitX());
-  Eigen::AngleAxisd current_rotation_y(param_.transform_param.pitch, Eigen::Vector3d::UnitY());
-  Eigen::AngleAxisd current_rotation_z(param_.transform_param.yaw+1.5708, Eigen::Vector3d::UnitZ());
-  Eigen::Translation3d current_translation(param_.transform_param.x, param_.transform_param.y,
-                                           param_.transform_param.z);
-  trans_ = (current_translation * current_rotation_z * current_rotation_y * current_rotation_x).matrix();  
-#endif
+  if ((param_.split_frame_mode == SplitFrameMode::SPLIT_BY_TIME) && (param_.split_period <= 0.0))
+  {
+    param_.split_period = 0.1;
+
+    RS_WARNING << "split_period should be greater than 0 when split_frame_mode is SPLIT_BY_TIME."
+               << " reset it to be 0.1." << RS_REND;
+  }
+
+  if (param_.organized && param_.dense_points)
+  {
+    param_.organized = false;
+
+    RS_WARNING << "organized cannot be true when dense_points is true."
+               << " reset it to be false." << RS_REND;
+  }
+
+  if ((CLOUD_KIND == CLOUD_RANGE_IMAGE) && (param_.dense_points || !transform_.isIdentity()))
+  {
+    RS_WARNING << "dense_points and transform_param are ignored for range image." << RS_REND;
+  }
+
+  if ((CLOUD_KIND != CLOUD_POINTS) && (param_.voxel_size > 0.0f))
+  {
+    param_.voxel_size = 0.0f;
+
+    RS_WARNING << "voxel_size is ignored for range image and polar cloud." << RS_REND;
+  }
+
+  if ((param_.dual_return_mode == DUAL_RETURN_SPLIT) && (param_.voxel_size > 0.0f))
+  {
+    param_.dual_return_mode = DUAL_RETURN_ALL;
+    dual_return_ = DualReturnFilter(param_.dual_return_mode, param_.dual_return_tolerance);
+
+    RS_WARNING << "dual_return_mode cannot be DUAL_RETURN_SPLIT when voxel_size > 0."
+               << " reset it to be DUAL_RETURN_ALL." << RS_REND;
+  }
+
+  if (((param_.sector_pkts > 0) || (param_.sector_angle > 0.0f)) && 
+      ((CLOUD_KIND != CLOUD_POINTS) || param_.organized || (param_.voxel_size > 0.0f)))
+  {
+    param_.sector_pkts = 0;
+    param_.sector_angle = 0.0f;
+
+    RS_WARNING << "sectors are only output for unorganized point cloud, without voxel_size."
+               << " reset sector_pkts/sector_angle to be 0." << RS_REND;
+  }
+
+  if ((CLOUD_KIND != CLOUD_POINTS) && !param_.crop_boxes.empty())
+  {
+    RS_WARNING << "crop_boxes are ignored for range image and polar cloud." << RS_REND;
+  }
+
+  const RSRingAzimuthMask& mask = param_.ring_azimuth_mask;
+  if ((mask.azimuth_bins > 0) && (mask.masked.size() % mask.azimuth_bins != 0))
+  {
+    RS_WARNING << "size of ring_azimuth_mask.masked is not a multiple of azimuth_bins."
+               << " the last incomplete ring is ignored." << RS_REND;
+  }
+
+  if ((CLOUD_KIND == CLOUD_POLAR) && (param_.organized || !transform_.isIdentity()))
+  {
+    param_.organized = false;
+
+    RS_WARNING << "organized and transform_param are ignored for polar cloud."
+               << " apply transform_param with PolarCloudView instead." << RS_REND;
+  }
+
+  //
+  // invalid points are kept for the pairs of returns and the columns of range image. otherwise they are 
+  // dropped in dense mode, so they are not staged.
+  //
+  batch_.setSkipNan(param_.dense_points && (param_.dual_return_mode == DUAL_RETURN_ALL) && 
+      (CLOUD_KIND != CLOUD_RANGE_IMAGE));
+
+  bindFlushBatch(std::integral_constant<int, CLOUD_KIND>());
+  bindDirect();
+}
+
+//
+// without any stage of batch, points are written into point_cloud_ as they are decoded, 
+// instead of being staged and copied.
+//
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::bindDirect()
+{
+  direct_ = (CLOUD_KIND == CLOUD_POINTS) && transform_.isIdentity() && !roi_.hasBoxes(false) && 
+    !roi_.hasBoxes(true) && !(param_.voxel_size > 0.0f) && (param_.dual_return_mode == DUAL_RETURN_ALL) && 
+    !param_.organized && !cb_get_pose_ && !cb_put_sector_;
+}
+
+//
+// choose the specialized path of point cloud once, instead of checking per packet or per point.
+// the transform is applied earlier, if the voxel grid or the crop boxes work in the user frame.
+//
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::bindFlushBatch(std::integral_constant<int, CLOUD_POINTS> kind)
+{
+  bool transform = !transform_.isIdentity() && !(param_.voxel_size > 0.0f) && !roi_.hasBoxes(true);
+  if (param_.dense_points)
+  {
+    flush_points_ = transform ? &Decoder::template flushBatchImpl<true, true> : 
+      &Decoder::template flushBatchImpl<true, false>;
+  }
+  else if (param_.organized)
+  {
+    flush_points_ = transform ? &Decoder::template flushBatchOrganized<true> : 
+      &Decoder::template flushBatchOrganized<false>;
+  }
+  else
+  {
+    flush_points_ = transform ? &Decoder::template flushBatchImpl<false, true> : 
+      &Decoder::template flushBatchImpl<false, false>;
+  }
+}
+
+template <typename T_PointCloud>
+inline size_t Decoder<T_PointCloud>::getMaxPointsPerFrame()
+{
+  size_t pkts = pkts_per_frame_;
+
+  //
+  // a time window may cover a part of frame, or more than one frame. frames are split per packet, 
+  // so the packet across the boundary is in the earlier frame as a whole.
+  //
+  if ((param_.split_frame_mode == SplitFrameMode::SPLIT_BY_TIME) && (packet_duration_ > 0.0))
+  {
+    pkts = (size_t)std::ceil(param_.split_period / packet_duration_) + 1;
+  }
+
+  return pkts * const_param_.BLOCKS_PER_PKT * const_param_.CHANNELS_PER_BLOCK;
+}
+
+//
+// the worst case of getMaxPointsPerFrame(), whatever echo mode the DIFOP packet tells later.
+// packets of MEMS lidars carry both returns, so their frames are not larger in dual return mode.
+//
+template <typename T_PointCloud>
+inline size_t Decoder<T_PointCloud>::getMaxPointsPerFrameAnyEcho()
+{
+  return getMaxPointsPerFrame();
 }
 
 template <typename T_PointCloud>
@@ -389,13 +649,594 @@ inline double Decoder<T_PointCloud>::cloudTs()
 template <typename T_PointCloud>
 inline void Decoder<T_PointCloud>::transformPoint(float& x, float& y, float& z)
 {
-#ifdef ENABLE_TRANSFORM
-  Eigen::Vector4d target_ori(x, y, z, 1);
-  Eigen::Vector4d target_rotate = trans_ * target_ori;
-  x = target_rotate(0);
-  y = target_rotate(1);
-  z = target_rotate(2);
-#endif
+  if (!transform_.isIdentity())
+  {
+    transform_.apply(x, y, z);
+  }
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::pushPoint(float x, float y, float z, uint8_t intensity, double timestamp, 
+    uint16_t ring, float distance, int32_t azimuth, int32_t elevation)
+{
+  if (direct_)
+  {
+    writePoint(x, y, z, intensity, timestamp, ring);
+    return;
+  }
+
+  batch_.push(x, y, z, intensity, timestamp, ring, distance, azimuth, elevation);
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::pushNanPoint(double timestamp, uint16_t ring)
+{
+  if (direct_)
+  {
+    if (!param_.dense_points)
+    {
+      writePoint(NAN, NAN, NAN, 0, timestamp, ring);
+    }
+    return;
+  }
+
+  batch_.pushNan(timestamp, ring);
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::writePoint(float x, float y, float z, uint8_t intensity, double timestamp, 
+    uint16_t ring)
+{
+  if (new_frame_)
+  {
+    frame_ts_base_ = timestamp;
+    new_frame_ = false;
+  }
+
+  if (param_.dense_points && !isValidPoint<T_PointCloud>(x, y, z))
+  {
+    return;
+  }
+
+  addPoint(*point_cloud_, x, y, z, intensity, timestamp, ring, frame_ts_base_);
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushBatch()
+{
+  if (batch_.size() == 0)
+  {
+    return;
+  }
+
+  if (new_frame_)
+  {
+    frame_ts_base_ = batch_.timestamps_[0];
+    new_frame_ = false;
+  }
+
+  if ((echo_mode_ == ECHO_DUAL) && dual_return_.enabled())
+  {
+    if (dual_return_.splitting())
+      dual_return_.split(batch_, echo_batch_);
+    else
+      dual_return_.apply(batch_);
+  }
+
+  uint32_t frame_pts = frame_pts_;
+  flushBatch(std::integral_constant<int, CLOUD_KIND>());
+  if (cb_put_sector_)
+  {
+    trackSector();
+  }
+  batch_.clear();
+
+  if (echo_batch_.size() > 0)
+  {
+    //
+    // write the second returns into echo_cloud_ through the same path. 
+    // they are aligned with the first returns, so start from the same point of the frame.
+    //
+    if (echo_cloud_)
+    {
+      std::swap(batch_, echo_batch_);
+      std::swap(point_cloud_, echo_cloud_);
+      std::swap(frame_pts_, frame_pts);
+
+      flushBatch(std::integral_constant<int, CLOUD_KIND>());
+
+      std::swap(frame_pts_, frame_pts);
+      std::swap(point_cloud_, echo_cloud_);
+      std::swap(batch_, echo_batch_);
+    }
+
+    echo_batch_.clear();
+  }
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushBatch(std::integral_constant<int, CLOUD_RANGE_IMAGE> kind)
+{
+  flushBatchRangeImage();
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushBatch(std::integral_constant<int, CLOUD_POLAR> kind)
+{
+  if (param_.dense_points)
+    flushBatchPolar<true>();
+  else
+    flushBatchPolar<false>();
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushBatch(std::integral_constant<int, CLOUD_POINTS> kind)
+{
+  if (roi_.hasBoxes(false))
+  {
+    roi_.applyBoxes(false, batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), 
+        batch_.intensities_.data(), batch_.distances_.data(), batch_.size());
+  }
+
+  if (cb_get_pose_)
+  {
+    deskewBatch();
+  }
+
+  if (!transform_.isIdentity() && ((param_.voxel_size > 0.0f) || roi_.hasBoxes(true)))
+  {
+    transform_.apply(batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), batch_.size());
+  }
+
+  if (roi_.hasBoxes(true))
+  {
+    roi_.applyBoxes(true, batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), 
+        batch_.intensities_.data(), batch_.distances_.data(), batch_.size());
+  }
+
+  if (param_.voxel_size > 0.0f)
+  {
+    voxel_grid_.add(batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), batch_.intensities_.data(), 
+        batch_.timestamps_.data(), batch_.rings_.data(), batch_.size());
+
+    // the downsampled cloud is output instead of the full one.
+    if (!voxel_cloud_)
+    {
+      return;
+    }
+  }
+
+  (this->*flush_points_)();
+}
+
+template <typename T_PointCloud>
+template <bool DENSE, bool TRANSFORM>
+inline void Decoder<T_PointCloud>::flushBatchImpl()
+{
+  size_t num = batch_.size();
+
+  if (TRANSFORM)
+  {
+    transform_.apply(batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), num);
+  }
+
+  for (size_t i = 0; i < num; i++)
+  {
+    // points made invalid by the filters, e.g. crop boxes, are NaN. drop them if dense points are required.
+    // so are points out of range of quantized coordinates.
+    if (DENSE && !isValidPoint<T_PointCloud>(batch_.xs_[i], batch_.ys_[i], batch_.zs_[i]))
+    {
+      continue;
+    }
+
+    addPoint(*point_cloud_, batch_.xs_[i], batch_.ys_[i], batch_.zs_[i], 
+        batch_.intensities_[i], batch_.timestamps_[i], batch_.rings_[i], frame_ts_base_);
+  }
+}
+
+template <typename T_PointCloud>
+template <bool TRANSFORM>
+inline void Decoder<T_PointCloud>::flushBatchOrganized()
+{
+  size_t num = batch_.size();
+  uint16_t height = const_param_.LASER_NUM;
+
+  if (TRANSFORM)
+  {
+    transform_.apply(batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), num);
+  }
+
+  //
+  // a new frame. allocate the grid of height x width, and fill it with NAN points.
+  //
+  if (pointNum(*point_cloud_) == 0)
+  {
+    frame_pts_ = 0;
+    frame_width_ = expectedWidth();
+
+    resizePoints(*point_cloud_, (size_t)height * frame_width_);
+    for (uint16_t row = 0; row < height; row++)
+    {
+      size_t base = (size_t)row * frame_width_;
+      for (uint32_t col = 0; col < frame_width_; col++)
+      {
+        setPointAt(*point_cloud_, base + col, NAN, NAN, NAN, 0, 0.0, row);
+      }
+    }
+  }
+
+  uint32_t width = (uint32_t)(pointNum(*point_cloud_) / height);
+  uint32_t cols = (uint32_t)((frame_pts_ + num + height - 1) / height);
+  if (cols > width)
+  {
+    width = growOrganized(width, grownWidth(width, cols));
+  }
+
+  //
+  // every column has exactly LASER_NUM points (including NAN ones) in firing order,
+  // so the column is derived from the point's order in the frame.
+  //
+  bool overflow = false;
+  for (size_t i = 0; i < num; i++)
+  {
+    uint32_t col = (uint32_t)((frame_pts_ + i) / height);
+    uint16_t row = batch_.rings_[i];
+    if ((col >= width) || (row >= height))
+    {
+      overflow |= (col >= width);
+      continue;
+    }
+
+    setPointAt(*point_cloud_, (size_t)row * width + col, batch_.xs_[i], batch_.ys_[i], batch_.zs_[i], 
+        batch_.intensities_[i], batch_.timestamps_[i], row, frame_ts_base_);
+  }
+
+  if (overflow)
+  {
+    LIMIT_CALL(this->cb_excep_(Error(ERRCODE_CLOUDOVERFLOW)), 1);
+  }
+
+  frame_pts_ += (uint32_t)num;
+}
+
+//
+// columns of a frame, in organized mode or range image. In dual return mode, getMaxPointsPerFrame() counts
+// both returns, but DUAL_RETURN_STRONGEST/LAST/FIRST/SPLIT leave only one of them in the point cloud.
+//
+template <typename T_PointCloud>
+inline uint32_t Decoder<T_PointCloud>::expectedWidth()
+{
+  uint32_t width = (uint32_t)(getMaxPointsPerFrame() / const_param_.LASER_NUM);
+  if ((echo_mode_ == ECHO_DUAL) && dual_return_.halving())
+  {
+    width = (width + 1) / 2;
+  }
+
+  return width;
+}
+
+//
+// the frame is longer than expected, e.g. the lidar turns slower than its nominal speed. 
+// grow the grid by a quarter at least, but never beyond twice the expected width.
+//
+template <typename T_PointCloud>
+inline uint32_t Decoder<T_PointCloud>::grownWidth(uint32_t width, uint32_t cols)
+{
+  uint32_t max_width = frame_width_ * 2;
+  return std::max(width, std::min(std::max(cols, width + width / 4), max_width));
+}
+
+//
+// re-layout the rows of the organized point cloud, with NAN points in the new columns.
+// the width may be kept, if the cloud is on a buffer of fixed size.
+//
+template <typename T_PointCloud>
+inline uint32_t Decoder<T_PointCloud>::growOrganized(uint32_t width, uint32_t new_width)
+{
+  uint16_t height = const_param_.LASER_NUM;
+  T_PointCloud& cloud = *point_cloud_;
+
+  resizePoints(cloud, (size_t)height * new_width);
+  if ((new_width <= width) || (pointNum(cloud) < (size_t)height * new_width))
+  {
+    resizePoints(cloud, (size_t)height * width);
+    return width;
+  }
+
+  // from the last row, so that no point is overwritten before it is moved.
+  for (size_t row = height; row-- > 0; )
+  {
+    for (size_t col = width; col-- > 0; )
+    {
+      movePointAt(cloud, row * new_width + col, row * width + col);
+    }
+
+    for (size_t col = width; col < new_width; col++)
+    {
+      setPointAt(cloud, row * new_width + col, NAN, NAN, NAN, 0, 0.0, (uint16_t)row);
+    }
+  }
+
+  return new_width;
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::growRangeImage(uint32_t width, uint32_t new_width)
+{
+  if (new_width <= width)
+  {
+    return;
+  }
+
+  uint16_t height = const_param_.LASER_NUM;
+  T_PointCloud& image = *point_cloud_;
+  image.distances.resize((size_t)height * new_width, 0);
+  image.intensities.resize((size_t)height * new_width, 0);
+  image.col_timestamps.resize(new_width, 0.0);
+
+  // from the last row, so that no row is overwritten before it is moved.
+  for (size_t row = height; row-- > 1; )
+  {
+    std::copy_backward(image.distances.begin() + row * width, image.distances.begin() + (row + 1) * width, 
+        image.distances.begin() + row * new_width + width);
+    std::copy_backward(image.intensities.begin() + row * width, image.intensities.begin() + (row + 1) * width, 
+        image.intensities.begin() + row * new_width + width);
+  }
+
+  for (size_t row = 0; row < height; row++)
+  {
+    std::fill(image.distances.begin() + row * new_width + width, image.distances.begin() + (row + 1) * new_width, 0);
+    std::fill(image.intensities.begin() + row * new_width + width, 
+        image.intensities.begin() + (row + 1) * new_width, 0);
+  }
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushBatchRangeImage()
+{
+  size_t num = batch_.size();
+  uint16_t height = const_param_.LASER_NUM;
+  T_PointCloud& image = *point_cloud_;
+
+  //
+  // a new frame. allocate the planes of height x width, and clear them.
+  //
+  if (image.size() == 0)
+  {
+    frame_pts_ = 0;
+    frame_width_ = expectedWidth();
+
+    size_t cells = (size_t)height * frame_width_;
+    image.distance_res = const_param_.DISTANCE_RES;
+    image.distances.assign(cells, 0);
+    image.intensities.assign(cells, 0);
+    image.col_timestamps.assign(frame_width_, 0.0);
+    image.row_vert_angles.assign(height, NAN);
+  }
+
+  uint32_t width = (uint32_t)image.col_timestamps.size();
+  uint32_t cols = (uint32_t)((frame_pts_ + num + height - 1) / height);
+  if (cols > width)
+  {
+    uint32_t new_width = grownWidth(width, cols);
+    growRangeImage(width, new_width);
+    width = new_width;
+  }
+
+  //
+  // same as the organized mode, the column is derived from the point's order in the frame.
+  //
+  bool overflow = false;
+  for (size_t i = 0; i < num; i++)
+  {
+    uint32_t col = (uint32_t)((frame_pts_ + i) / height);
+    uint16_t row = batch_.rings_[i];
+    if ((col >= width) || (row >= height))
+    {
+      overflow |= (col >= width);
+      continue;
+    }
+
+    if ((frame_pts_ + i) % height == 0)
+    {
+      image.col_timestamps[col] = batch_.timestamps_[i];
+    }
+
+    float distance = batch_.distances_[i];
+    if (distance > 0.0f)
+    {
+      size_t idx = (size_t)row * width + col;
+      image.distances[idx] = (uint16_t)(distance / const_param_.DISTANCE_RES + 0.5f);
+      image.intensities[idx] = batch_.intensities_[i];
+      if (batch_.elevations_[i] != PointBatch::ANGLE_UNKNOWN)
+      {
+        image.row_vert_angles[row] = batch_.elevations_[i] * 0.01f;
+      }
+    }
+  }
+
+  if (overflow)
+  {
+    LIMIT_CALL(this->cb_excep_(Error(ERRCODE_CLOUDOVERFLOW)), 1);
+  }
+
+  frame_pts_ += (uint32_t)num;
+}
+
+//
+// deskew points of the batch, to the pose at the first point of the frame. 
+// it is done in the LiDAR frame, before transform_ is applied.
+//
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::deskewBatch()
+{
+  if (deskew_ref_ts_ != frame_ts_base_)
+  {
+    RSPose ref_pose;
+    deskew_ref_ts_ = frame_ts_base_;
+    deskew_ref_ok_ = cb_get_pose_(deskew_ref_ts_, ref_pose);
+    deskew_nopose_ = false;
+    if (deskew_ref_ok_)
+    {
+      deskew_.setReference(ref_pose);
+    }
+  }
+
+  size_t num = batch_.size();
+  double ts_a = batch_.timestamps_[0];
+  double ts_b = batch_.timestamps_[num - 1];
+  RSPose pose_a, pose_b;
+  if (!deskew_ref_ok_ || !cb_get_pose_(ts_a, pose_a) || !cb_get_pose_(ts_b, pose_b))
+  {
+    // report once per frame, so that the user knows which frames are not deskewed.
+    if (!deskew_nopose_)
+    {
+      deskew_nopose_ = true;
+      this->cb_excep_(Error(ERRCODE_NOPOSE));
+    }
+    return;
+  }
+
+  deskew_.apply(batch_.xs_.data(), batch_.ys_.data(), batch_.zs_.data(), batch_.timestamps_.data(), num, 
+      ts_a, pose_a, ts_b, pose_b);
+}
+
+template <typename T_PointCloud>
+template <bool DENSE>
+inline void Decoder<T_PointCloud>::flushBatchPolar()
+{
+  size_t num = batch_.size();
+  T_PointCloud& cloud = *point_cloud_;
+
+  if (cloud.size() == 0)
+  {
+    cloud.ts_base = frame_ts_base_;
+    cloud.rx = rx_;
+    cloud.rz = rz_;
+  }
+
+  for (size_t i = 0; i < num; i++)
+  {
+    if (DENSE && (batch_.distances_[i] <= 0.0f))
+    {
+      continue;
+    }
+
+    cloud.distances.push_back(batch_.distances_[i]);
+    cloud.azimuths.push_back(batch_.azimuths_[i]);
+    cloud.elevations.push_back(batch_.elevations_[i]);
+    cloud.rings.push_back(batch_.rings_[i]);
+    cloud.intensities.push_back(batch_.intensities_[i]);
+    cloud.ts_offsets.push_back((float)(batch_.timestamps_[i] - frame_ts_base_));
+  }
+}
+
+//
+// a sector ends every sector_pkts packets, or every sector_angle degrees of azimuth. 
+// its points are already in point_cloud_, so only their range is given to the callback.
+//
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::trackSector()
+{
+  size_t num = batch_.size();
+  if (sector_ts_start_ < 0)
+  {
+    sector_ts_start_ = batch_.timestamps_[0];
+  }
+  sector_ts_end_ = batch_.timestamps_[num - 1];
+
+  for (size_t i = 0; i < num; i++)
+  {
+    if (batch_.azimuths_[i] != PointBatch::ANGLE_UNKNOWN)
+    {
+      if (sector_az_start_ == PointBatch::ANGLE_UNKNOWN)
+      {
+        sector_az_start_ = batch_.azimuths_[i];
+      }
+      break;
+    }
+  }
+
+  for (size_t i = num; i > 0; i--)
+  {
+    if (batch_.azimuths_[i - 1] != PointBatch::ANGLE_UNKNOWN)
+    {
+      sector_az_end_ = batch_.azimuths_[i - 1];
+      break;
+    }
+  }
+
+  sector_pkts_++;
+
+  bool end = (param_.sector_pkts > 0) && (sector_pkts_ >= param_.sector_pkts);
+  if (!end && (param_.sector_angle > 0.0f) && (sector_az_start_ != PointBatch::ANGLE_UNKNOWN))
+  {
+    int32_t az_diff = sector_az_end_ - sector_az_start_;
+    if (az_diff < 0) { az_diff += 36000; }
+
+    end = (az_diff >= (int32_t)(param_.sector_angle * 100));
+  }
+
+  if (end)
+  {
+    putSector(false);
+  }
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::putSector(bool last)
+{
+  size_t end = pointNum(*point_cloud_);
+
+  // the last sector is output even if it is empty, to mark the end of the frame.
+  if ((end > sector_start_) || last)
+  {
+    SectorInfo info;
+    info.index = sector_index_++;
+    info.last = last;
+    info.start_angle = (sector_az_start_ != PointBatch::ANGLE_UNKNOWN) ? (sector_az_start_ / 100.0f) : NAN;
+    info.end_angle = (sector_az_end_ != PointBatch::ANGLE_UNKNOWN) ? (sector_az_end_ / 100.0f) : NAN;
+    info.start_ts = (sector_ts_start_ < 0) ? sector_ts_end_ : sector_ts_start_;
+    info.end_ts = sector_ts_end_;
+
+    double ts = (TS_OFFSET || cb_get_pose_) ? frame_ts_base_ : 
+      (param_.ts_first_point ? info.start_ts : info.end_ts);
+
+    cb_put_sector_(sector_start_, end, ts, info);
+  }
+
+  sector_start_ = end;
+  sector_pkts_ = 0;
+  sector_az_start_ = sector_az_end_ = PointBatch::ANGLE_UNKNOWN;
+  sector_ts_start_ = -1.0;
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::flushFrame()
+{
+  splitFrame(const_param_.LASER_NUM, cloudTs());
+}
+
+template <typename T_PointCloud>
+inline void Decoder<T_PointCloud>::splitFrame(uint16_t height, double ts)
+{
+  // points before the split position belong to the frame to be split.
+  flushBatch();
+
+  if ((CLOUD_KIND == CLOUD_POINTS) && (param_.voxel_size > 0.0f))
+  {
+    voxel_grid_.output(voxel_cloud_ ? *voxel_cloud_ : *point_cloud_, frame_ts_base_);
+  }
+
+  if (cb_put_sector_)
+  {
+    putSector(true);
+    sector_index_ = 0;
+    sector_start_ = 0;
+  }
+
+  new_frame_ = true;
+  cb_split_frame_(height, (TS_OFFSET || cb_get_pose_) ? frame_ts_base_ : ts);
 }
 
 template <typename T_PointCloud>
@@ -417,42 +1258,63 @@ inline void Decoder<T_PointCloud>::processDifopPkt(const uint8_t* pkt, size_t si
 }
 
 template <typename T_PointCloud>
-inline bool Decoder<T_PointCloud>::processMsopPkt(const uint8_t* pkt, size_t size)
+inline ErrCode Decoder<T_PointCloud>::checkMsopPkt(const uint8_t* pkt, size_t size)
 {
-  constexpr static int CLOUD_POINT_MAX = 1000000;
-
-  if (this->point_cloud_ && (this->point_cloud_->points.size() > CLOUD_POINT_MAX))
-  {
-     LIMIT_CALL(this->cb_excep_(Error(ERRCODE_CLOUDOVERFLOW)), 1);
-  }
-
   if (param_.wait_for_difop && !angles_ready_)
   {
-     DELAY_LIMIT_CALL(cb_excep_(Error(ERRCODE_NODIFOPRECV)), 1);
-     return false;
+    return ERRCODE_NODIFOPRECV;
   }
 
   if (size != this->const_param_.MSOP_LEN)
   {
-     LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGMSOPLEN)), 1);
-     return false;
+    return ERRCODE_WRONGMSOPLEN;
   }
 
   if (memcmp(pkt, this->const_param_.MSOP_ID, this->const_param_.MSOP_ID_LEN) != 0)
   {
-    LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGMSOPID)), 1);
-    return false;
+    return ERRCODE_WRONGMSOPID;
   }
 
-#ifdef ENABLE_CRC32_CHECK
-  if (!isCrc32Correct(pkt, size))
+  if (this->param_.check_crc32 && !isCrc32Correct(pkt, size))
   {
-    LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGCRC32)), 1);
-    return false;
+    return ERRCODE_WRONGCRC32;
   }
-#endif
 
-  return decodeMsopPkt(pkt, size);
+  return ERRCODE_SUCCESS;
+}
+
+template <typename T_PointCloud>
+inline bool Decoder<T_PointCloud>::processMsopPkt(const uint8_t* pkt, size_t size)
+{
+  constexpr static int CLOUD_POINT_MAX = 1000000;
+
+  if (this->point_cloud_ && (pointNum(*this->point_cloud_) > CLOUD_POINT_MAX))
+  {
+     LIMIT_CALL(this->cb_excep_(Error(ERRCODE_CLOUDOVERFLOW)), 1);
+  }
+
+  // limit the calls of each error respectively
+  switch (checkMsopPkt(pkt, size))
+  {
+    case ERRCODE_SUCCESS:
+      return decodeMsopPkt(pkt, size);
+
+    case ERRCODE_NODIFOPRECV:
+      DELAY_LIMIT_CALL(cb_excep_(Error(ERRCODE_NODIFOPRECV)), 1);
+      return false;
+
+    case ERRCODE_WRONGMSOPLEN:
+      LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGMSOPLEN)), 1);
+      return false;
+
+    case ERRCODE_WRONGMSOPID:
+      LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGMSOPID)), 1);
+      return false;
+
+    default:
+      LIMIT_CALL(this->cb_excep_(Error(ERRCODE_WRONGCRC32)), 1);
+      return false;
+  }
 }
 
 }  // namespace lidar
@@ -38,8 +38,8 @@ namespace robosense
 {
 namespace lidar
 {
-template <typename T_PointCloud>
-class DecoderRS48 : public DecoderMech<T_PointCloud>
+template <typename T_PointCloud, typename T_SplitStrategy = SplitStrategyByAngle>
+class DecoderRS48 : public DecoderMech<T_PointCloud, T_SplitStrategy>
 {
 public:
   virtual void decodeDifopPkt(const uint8_t* pkt, size_t size);
@@ -55,12 +55,12 @@ protected:
   static RSDecoderMechConstParam& getConstParam();
   static RSEchoMode getEchoMode(uint8_t mode);
 
-  template <typename T_BlockIterator>
+  template <typename T_BlockIterator, bool FULL_FOV>
   bool internDecodeMsopPkt(const uint8_t* pkt, size_t size);
 };
 
-template <typename T_PointCloud>
-inline RSDecoderMechConstParam& DecoderRS48<T_PointCloud>::getConstParam()
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline RSDecoderMechConstParam& DecoderRS48<T_PointCloud, T_SplitStrategy>::getConstParam()
 {
   static RSDecoderMechConstParam param = 
   {
@@ -109,8 +109,8 @@ inline RSDecoderMechConstParam& DecoderRS48<T_PointCloud>::getConstParam()
   return param;
 }
 
-template <typename T_PointCloud>
-inline RSEchoMode DecoderRS48<T_PointCloud>::getEchoMode(uint8_t mode)
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline RSEchoMode DecoderRS48<T_PointCloud, T_SplitStrategy>::getEchoMode(uint8_t mode)
 {
   switch (mode)
   {
@@ -123,39 +123,43 @@ inline RSEchoMode DecoderRS48<T_PointCloud>::getEchoMode(uint8_t mode)
   }
 }
 
-template <typename T_PointCloud>
-inline void DecoderRS48<T_PointCloud>::decodeDifopPkt(const uint8_t* packet, size_t size)
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline void DecoderRS48<T_PointCloud, T_SplitStrategy>::decodeDifopPkt(const uint8_t* packet, size_t size)
 {
   const RSP48DifopPkt& pkt = *(const RSP48DifopPkt*)(packet);
   this->template decodeDifopCommon<RSP48DifopPkt>(pkt);
 
   this->echo_mode_ = getEchoMode (pkt.return_mode);
-  this->split_blks_per_frame_ = (this->echo_mode_ == RSEchoMode::ECHO_DUAL) ? 
-    (this->blks_per_frame_ << 1) : this->blks_per_frame_;
+  this->setSplitBlksPerFrame((this->echo_mode_ == RSEchoMode::ECHO_DUAL) ? 
+    (this->blks_per_frame_ << 1) : this->blks_per_frame_);
 }
 
-template <typename T_PointCloud>
-inline DecoderRS48<T_PointCloud>::DecoderRS48(const RSDecoderParam& param)
-  : DecoderMech<T_PointCloud>(getConstParam(), param)
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline DecoderRS48<T_PointCloud, T_SplitStrategy>::DecoderRS48(const RSDecoderParam& param)
+  : DecoderMech<T_PointCloud, T_SplitStrategy>(getConstParam(), param)
 {
 }
 
-template <typename T_PointCloud>
-inline bool DecoderRS48<T_PointCloud>::decodeMsopPkt(const uint8_t* pkt, size_t size)
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline bool DecoderRS48<T_PointCloud, T_SplitStrategy>::decodeMsopPkt(const uint8_t* pkt, size_t size)
 {
   if (this->echo_mode_ == RSEchoMode::ECHO_SINGLE)
   {
-    return internDecodeMsopPkt<SingleReturnBlockIterator<RSP48MsopPkt>>(pkt, size);
+    return this->scan_section_.fullRound() ?
+      internDecodeMsopPkt<SingleReturnBlockIterator<RSP48MsopPkt>, true>(pkt, size) :
+      internDecodeMsopPkt<SingleReturnBlockIterator<RSP48MsopPkt>, false>(pkt, size);
   }
   else
   {
-    return internDecodeMsopPkt<DualReturnBlockIterator<RSP48MsopPkt>>(pkt, size);
+    return this->scan_section_.fullRound() ?
+      internDecodeMsopPkt<DualReturnBlockIterator<RSP48MsopPkt>, true>(pkt, size) :
+      internDecodeMsopPkt<DualReturnBlockIterator<RSP48MsopPkt>, false>(pkt, size);
   }
 }
 
-template <typename T_PointCloud>
-template <typename T_BlockIterator>
-inline bool DecoderRS48<T_PointCloud>::internDecodeMsopPkt(const uint8_t* packet, size_t size)
+template <typename T_PointCloud, typename T_SplitStrategy>
+template <typename T_BlockIterator, bool FULL_FOV>
+inline bool DecoderRS48<T_PointCloud, T_SplitStrategy>::internDecodeMsopPkt(const uint8_t* packet, size_t size)
 {
   const RSP48MsopPkt& pkt = *(const RSP48MsopPkt*)(packet);
   bool ret = false;
@@ -199,9 +203,9 @@ inline bool DecoderRS48<T_PointCloud>::internDecodeMsopPkt(const uint8_t* packet
 
     double block_ts = pkt_ts + block_ts_off;
     int32_t block_az = ntohs(block.azimuth);
-    if (this->split_strategy_->newBlock(block_az))
+    if (this->split_strategy_.newBlock(block_az, block_ts))
     {
-      this->cb_split_frame_(this->const_param_.LASER_NUM, this->cloudTs());
+      this->splitFrame(this->const_param_.LASER_NUM, this->cloudTs());
       this->first_point_ts_ = block_ts;
       ret = true;
     }
@@ -218,40 +222,31 @@ inline bool DecoderRS48<T_PointCloud>::internDecodeMsopPkt(const uint8_t* packet
       int32_t angle_horiz_final = this->chan_angles_.horizAdjust(chan, angle_horiz);
       float distance = ntohs(channel.distance) * this->const_param_.DISTANCE_RES;
 
-      if (this->distance_section_.in(distance) && this->scan_section_.in(angle_horiz_final))
+      if (this->distance_section_.in(distance) && (FULL_FOV || this->scan_section_.in(angle_horiz_final)) &&
+          !this->roi_.masked(this->chan_angles_.toUserChan(chan), angle_horiz_final))
       {
-        float x =  distance * COS(angle_vert) * COS(angle_horiz_final) + this->mech_const_param_.RX * COS(angle_horiz);
-        float y = -distance * COS(angle_vert) * SIN(angle_horiz_final) - this->mech_const_param_.RX * SIN(angle_horiz);
-        float z =  distance * SIN(angle_vert) + this->mech_const_param_.RZ;
-        this->transformPoint(x, y, z);
-
-        typename T_PointCloud::PointT point;
-        setX(point, x);
-        setY(point, y);
-        setZ(point, z);
-        setIntensity(point, channel.intensity);
-        setTimestamp(point, chan_ts);
-        setRing(point, this->chan_angles_.toUserChan(chan));
-
-        this->point_cloud_->points.emplace_back(point);
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        if (this->XYZ)
+        {
+          x =  distance * COS(angle_vert) * COS(angle_horiz_final) + this->mech_const_param_.RX * COS(angle_horiz);
+          y = -distance * COS(angle_vert) * SIN(angle_horiz_final) - this->mech_const_param_.RX * SIN(angle_horiz);
+          z =  distance * SIN(angle_vert) + this->mech_const_param_.RZ;
+        }
+
+        this->pushPoint(x, y, z, channel.intensity, chan_ts, this->chan_angles_.toUserChan(chan),
+            distance, angle_horiz_final, angle_vert);
       }
-      else if (!this->param_.dense_points)
+      else
       {
-        typename T_PointCloud::PointT point;
-        setX(point, NAN);
-        setY(point, NAN);
-        setZ(point, NAN);
-        setIntensity(point, 0);
-        setTimestamp(point, chan_ts);
-        setRing(point, this->chan_angles_.toUserChan(chan));
-
-        this->point_cloud_->points.emplace_back(point);
+        this->pushNanPoint(chan_ts, this->chan_angles_.toUserChan(chan));
       }
 
       this->prev_point_ts_ = chan_ts;
     }
   }
 
+  this->flushBatch();
+
   this->prev_pkt_ts_ = pkt_ts;
   return ret;
 }
@@ -99,6 +99,7 @@ private:
   RSEchoMode getEchoMode(uint8_t mode);
 
   SplitStrategyBySeq split_strategy_;
+  SplitStrategyByTime split_time_; // used instead of split_strategy_, if split_frame_mode is SPLIT_BY_TIME
 };
 
 template <typename T_PointCloud>
@@ -128,8 +129,10 @@ inline RSDecoderConstParam& DecoderRSE1<T_PointCloud>::getConstParam()
 template <typename T_PointCloud>
 inline DecoderRSE1<T_PointCloud>::DecoderRSE1(const RSDecoderParam& param)
   : Decoder<T_PointCloud>(getConstParam(), param)
+  , split_time_(this->param_.split_period)
 {
   this->packet_duration_ = FRAME_DURATION / SINGLE_PKT_NUM;
+  this->pkts_per_frame_ = SINGLE_PKT_NUM;
   this->angles_ready_ = true;
 }
 
@@ -180,9 +183,11 @@ inline bool DecoderRSE1<T_PointCloud>::decodeMsopPkt(const uint8_t* packet, size
   }
 
   uint16_t pkt_seq = ntohs(pkt.header.pkt_seq);
-  if (split_strategy_.newPacket(pkt_seq))
+  bool to_split = (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_TIME) ?
+    split_time_.newTime(pkt_ts) : split_strategy_.newPacket(pkt_seq);
+  if (to_split)
   {
-    this->cb_split_frame_(this->const_param_.LASER_NUM, this->cloudTs());
+    this->splitFrame(this->const_param_.LASER_NUM, this->cloudTs());
     this->first_point_ts_ = pkt_ts;
     ret = true;
   }
@@ -205,39 +210,28 @@ inline bool DecoderRSE1<T_PointCloud>::decodeMsopPkt(const uint8_t* packet, size
         int16_t vector_y = RS_SWAP_INT16(channel.y);
         int16_t vector_z = RS_SWAP_INT16(channel.z);
 
-        float x = vector_x * distance / VECTOR_BASE;
-        float y = vector_y * distance / VECTOR_BASE;
-        float z = vector_z * distance / VECTOR_BASE;
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        if (this->XYZ)
+        {
+          x = vector_x * distance / VECTOR_BASE;
+          y = vector_y * distance / VECTOR_BASE;
+          z = vector_z * distance / VECTOR_BASE;
+        }
 
-        this->transformPoint(x, y, z);
-
-        typename T_PointCloud::PointT point;
-        setX(point, x);
-        setY(point, y);
-        setZ(point, z);
-        setIntensity(point, channel.intensity);
-        setTimestamp(point, point_time);
-        setRing(point, chan);
-
-        this->point_cloud_->points.emplace_back(point);
+        this->pushPoint(x, y, z, channel.intensity, point_time, chan,
+            distance);
       }
-      else if (!this->param_.dense_points)
+      else
       {
-        typename T_PointCloud::PointT point;
-        setX(point, NAN);
-        setY(point, NAN);
-        setZ(point, NAN);
-        setIntensity(point, 0);
-        setTimestamp(point, point_time);
-        setRing(point, chan);
-
-        this->point_cloud_->points.emplace_back(point);
+        this->pushNanPoint(point_time, chan);
       }
     }
 
     this->prev_point_ts_ = point_time;
   }
 
+  this->flushBatch();
+
   this->prev_pkt_ts_ = pkt_ts;
   return ret;
 }
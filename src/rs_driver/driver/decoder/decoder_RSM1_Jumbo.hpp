@@ -92,6 +92,7 @@ private:
 
   bool internDecodeMsopPkt(const uint8_t* pkt, size_t size);
   SplitStrategyBySeq split_strategy_;
+  SplitStrategyByTime split_time_; // used instead of split_strategy_, if split_frame_mode is SPLIT_BY_TIME
 };
 
 template <typename T_PointCloud>
@@ -121,8 +122,10 @@ inline RSDecoderConstParam& DecoderRSM1_Jumbo<T_PointCloud>::getConstParam()
 template <typename T_PointCloud>
 inline DecoderRSM1_Jumbo<T_PointCloud>::DecoderRSM1_Jumbo(const RSDecoderParam& param)
   : Decoder<T_PointCloud>(getConstParam(), param)
+  , split_time_(this->param_.split_period)
 {
   this->packet_duration_ = FRAME_DURATION / SINGLE_PKT_NUM;
+  this->pkts_per_frame_ = SINGLE_PKT_NUM;
   this->angles_ready_ = true;
 }
 
@@ -198,9 +201,11 @@ inline bool DecoderRSM1_Jumbo<T_PointCloud>::internDecodeMsopPkt(const uint8_t*
   }
 
   uint16_t pkt_seq = ntohs(pkt.header.pkt_seq);
-  if (split_strategy_.newPacket(pkt_seq))
+  bool to_split = (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_TIME) ?
+    split_time_.newTime(pkt_ts) : split_strategy_.newPacket(pkt_seq);
+  if (to_split)
   {
-    this->cb_split_frame_(this->const_param_.LASER_NUM, this->cloudTs());
+    this->splitFrame(this->const_param_.LASER_NUM, this->cloudTs());
     this->first_point_ts_ = pkt_ts;
     ret = true;
   }
@@ -216,44 +221,34 @@ inline bool DecoderRSM1_Jumbo<T_PointCloud>::internDecodeMsopPkt(const uint8_t*
       const RSM1_Jumbo_Channel& channel = block.channel[chan];
 
       float distance = ntohs(channel.distance) * this->const_param_.DISTANCE_RES;
+      int pitch = ntohs(channel.pitch) - ANGLE_OFFSET;
+      int yaw = ntohs(channel.yaw) - ANGLE_OFFSET;
 
-      if (this->distance_section_.in(distance))
+      // azimuth in the convention of mechanical lidars, i.e. clockwise
+      if (this->distance_section_.in(distance) && !this->roi_.masked(chan, -yaw))
       {
-        int pitch = ntohs(channel.pitch) - ANGLE_OFFSET;
-        int yaw = ntohs(channel.yaw) - ANGLE_OFFSET;
-
-        float x = distance * COS (pitch) * COS (yaw);
-        float y = distance * COS (pitch) * SIN (yaw);
-        float z = distance * SIN (pitch);
-        this->transformPoint(x, y, z);
-
-        typename T_PointCloud::PointT point;
-        setX(point, x);
-        setY(point, y);
-        setZ(point, z);
-        setIntensity(point, channel.intensity);
-        setTimestamp(point, point_time);
-        setRing(point, chan);
-
-        this->point_cloud_->points.emplace_back(point);
+        float x = 0.0f, y = 0.0f, z = 0.0f;
+        if (this->XYZ)
+        {
+          x = distance * COS (pitch) * COS (yaw);
+          y = distance * COS (pitch) * SIN (yaw);
+          z = distance * SIN (pitch);
+        }
+
+        this->pushPoint(x, y, z, channel.intensity, point_time, chan,
+            distance, -yaw, pitch);
       }
-      else if (!this->param_.dense_points)
+      else
       {
-        typename T_PointCloud::PointT point;
-        setX(point, NAN);
-        setY(point, NAN);
-        setZ(point, NAN);
-        setIntensity(point, 0);
-        setTimestamp(point, point_time);
-        setRing(point, chan);
-
-        this->point_cloud_->points.emplace_back(point);
+        this->pushNanPoint(point_time, chan);
       }
     }
 
     this->prev_point_ts_ = point_time;
   }
 
+  this->flushBatch();
+
   this->prev_pkt_ts_ = pkt_ts;
   return ret;
 }
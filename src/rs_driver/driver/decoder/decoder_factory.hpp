@@ -62,8 +62,39 @@ public:
 
   static std::shared_ptr<Decoder<T_PointCloud>> createDecoder(
       LidarType type, const RSDecoderParam& param);
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  template <template <typename, typename> class T_DecoderMech>
+  static std::shared_ptr<Decoder<T_PointCloud>> createDecoderMech(const RSDecoderParam& param);
 };
 
+template <typename T_PointCloud>
+template <template <typename, typename> class T_DecoderMech>
+inline std::shared_ptr<Decoder<T_PointCloud>> DecoderFactory<T_PointCloud>::createDecoderMech(
+    const RSDecoderParam& param)
+{
+  //
+  // instantiate the decoder with the split strategy, 
+  // so that the strategy is inlined into its decoding loop.
+  //
+  switch (param.split_frame_mode)
+  {
+    case SplitFrameMode::SPLIT_BY_FIXED_BLKS:
+    case SplitFrameMode::SPLIT_BY_CUSTOM_BLKS:
+      return std::make_shared<T_DecoderMech<T_PointCloud, SplitStrategyByNum>>(param);
+
+    case SplitFrameMode::SPLIT_BY_TIME:
+      return std::make_shared<T_DecoderMech<T_PointCloud, SplitStrategyByTime>>(param);
+
+    case SplitFrameMode::SPLIT_BY_ANGLE:
+    default:
+      return std::make_shared<T_DecoderMech<T_PointCloud, SplitStrategyByAngle>>(param);
+  }
+}
+
 template <typename T_PointCloud>
 inline std::shared_ptr<Decoder<T_PointCloud>> DecoderFactory<T_PointCloud>::createDecoder(
     LidarType type, const RSDecoderParam& param)
@@ -73,40 +104,40 @@ inline std::shared_ptr<Decoder<T_PointCloud>> DecoderFactory<T_PointCloud>::crea
   switch (type)
   {
     case LidarType::RS16:
-      ret_ptr = std::make_shared<DecoderRS16<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRS16>(param);
       break;
     case LidarType::RS32:
-      ret_ptr = std::make_shared<DecoderRS32<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRS32>(param);
       break;
     case LidarType::RSBP:
-      ret_ptr = std::make_shared<DecoderRSBP<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSBP>(param);
       break;
     case LidarType::RSBPV4:
-      ret_ptr = std::make_shared<DecoderRSBPV4<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSBPV4>(param);
       break;
     case LidarType::RSHELIOS:
-      ret_ptr = std::make_shared<DecoderRSHELIOS<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSHELIOS>(param);
       break;
     case LidarType::RSHELIOS_16P:
-      ret_ptr = std::make_shared<DecoderRSHELIOS_16P<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSHELIOS_16P>(param);
       break;
     case LidarType::RS128:
-      ret_ptr = std::make_shared<DecoderRS128<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRS128>(param);
       break;
     case LidarType::RS80:
-      ret_ptr = std::make_shared<DecoderRS80<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRS80>(param);
       break;
     case LidarType::RS48:
-      ret_ptr = std::make_shared<DecoderRS48<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRS48>(param);
       break;
     case LidarType::RSP128:
-      ret_ptr = std::make_shared<DecoderRSP128<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSP128>(param);
       break;
     case LidarType::RSP80:
-      ret_ptr = std::make_shared<DecoderRSP80<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSP80>(param);
       break;
     case LidarType::RSP48:
-      ret_ptr = std::make_shared<DecoderRSP48<T_PointCloud>>(param);
+      ret_ptr = createDecoderMech<DecoderRSP48>(param);
       break;
     case LidarType::RSM1:
       ret_ptr = std::make_shared<DecoderRSM1<T_PointCloud>>(param);
@@ -69,7 +69,7 @@ typedef struct
   RSCalibrationAngle horiz_angle_cali[32];
 } AdapterDifopPkt;
 
-template <typename T_PointCloud>
+template <typename T_PointCloud, typename T_SplitStrategy = SplitStrategyByAngle>
 class DecoderMech : public Decoder<T_PointCloud>
 {
 public:
@@ -81,6 +81,9 @@ public:
   explicit DecoderMech(const RSDecoderMechConstParam& const_param, const RSDecoderParam& param);
 
   void print();
+  virtual size_t getMaxPointsPerFrame();
+  virtual size_t getMaxPointsPerFrameAnyEcho();
+  virtual void resetSplitStrategy();
 
 #ifndef UNIT_TEST
 protected:
@@ -88,21 +91,34 @@ protected:
 
   template <typename T_Difop>
   void decodeDifopCommon(const T_Difop& pkt);
+  size_t maxPointsPerFrame(uint16_t split_blks_per_frame);
+  virtual uint16_t dualBlksPerFrame(); // split_blks_per_frame_ in dual return mode
+  void setSplitBlksPerFrame(uint16_t split_blks_per_frame);
+
+  SplitStrategyByAngle createSplitStrategy(const SplitStrategyByAngle*);
+  SplitStrategyByNum createSplitStrategy(const SplitStrategyByNum*);
+  SplitStrategyByTime createSplitStrategy(const SplitStrategyByTime*);
+  void updateSplitStrategy(SplitStrategyByAngle&) {}
+  void updateSplitStrategy(SplitStrategyByNum& strategy);
+  void updateSplitStrategy(SplitStrategyByTime&) {}
+  static SplitFrameMode splitMode(const SplitStrategyByAngle*, SplitFrameMode mode);
+  static SplitFrameMode splitMode(const SplitStrategyByNum*, SplitFrameMode mode);
+  static SplitFrameMode splitMode(const SplitStrategyByTime*, SplitFrameMode mode);
 
   RSDecoderMechConstParam mech_const_param_; // const param 
   ChanAngles chan_angles_; // vert_angles/horiz_angles adjustment
   AzimuthSection scan_section_; // valid azimuth section
-  std::shared_ptr<SplitStrategy> split_strategy_; // split strategy
 
   uint16_t rps_; // rounds per second
   uint16_t blks_per_frame_; // blocks per frame/round
   uint16_t split_blks_per_frame_; // blocks in msop pkt per frame/round. 
+  T_SplitStrategy split_strategy_; // split strategy, chosen by DecoderFactory
   uint16_t block_az_diff_; // azimuth difference between adjacent blocks.
   double fov_blind_ts_diff_; // timestamp difference across blind section(defined by fov)
 };
 
-template <typename T_PointCloud>
-inline DecoderMech<T_PointCloud>::DecoderMech(const RSDecoderMechConstParam& const_param, 
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline DecoderMech<T_PointCloud, T_SplitStrategy>::DecoderMech(const RSDecoderMechConstParam& const_param, 
     const RSDecoderParam& param)
   : Decoder<T_PointCloud>(const_param.base, param)
   , mech_const_param_(const_param)
@@ -111,27 +127,26 @@ inline DecoderMech<T_PointCloud>::DecoderMech(const RSDecoderMechConstParam& con
   , rps_(10)
   , blks_per_frame_((uint16_t)(1 / (10 * this->mech_const_param_.BLOCK_DURATION)))
   , split_blks_per_frame_(blks_per_frame_)
+  , split_strategy_(createSplitStrategy((const T_SplitStrategy*)nullptr))
   , block_az_diff_(20)
   , fov_blind_ts_diff_(0.0)
 {
   this->packet_duration_ = 
     this->mech_const_param_.BLOCK_DURATION * this->const_param_.BLOCKS_PER_PKT;
-
-  switch (this->param_.split_frame_mode)
+  this->rx_ = this->mech_const_param_.RX;
+  this->rz_ = this->mech_const_param_.RZ;
+  this->dual_return_.setStride(this->const_param_.LASER_NUM);
+
+  //
+  // the decoder may be instantiated with the default split strategy, instead of by DecoderFactory.
+  //
+  SplitFrameMode split_mode = splitMode((const T_SplitStrategy*)nullptr, this->param_.split_frame_mode);
+  if (split_mode != this->param_.split_frame_mode)
   {
-    case SplitFrameMode::SPLIT_BY_FIXED_BLKS:
-      split_strategy_ = std::make_shared<SplitStrategyByNum>(&this->split_blks_per_frame_);
-      break;
-
-    case SplitFrameMode::SPLIT_BY_CUSTOM_BLKS:
-      split_strategy_ = std::make_shared<SplitStrategyByNum>(&this->param_.num_blks_split);
-      break;
-
-    case SplitFrameMode::SPLIT_BY_ANGLE:
-    default:
-      uint16_t angle = (uint16_t)(this->param_.split_angle * 100);
-      split_strategy_ = std::make_shared<SplitStrategyByAngle>(angle);
-      break;
+    RS_WARNING << "split_frame_mode " << this->param_.split_frame_mode 
+               << " does not match the split strategy of the decoder. reset it to be " << split_mode << "."
+               << " create the decoder with DecoderFactory instead." << RS_REND;
+    this->param_.split_frame_mode = split_mode;
   }
 
   if (this->param_.config_from_file)
@@ -149,8 +164,110 @@ inline DecoderMech<T_PointCloud>::DecoderMech(const RSDecoderMechConstParam& con
   }
 }
 
-template <typename T_PointCloud>
-inline void DecoderMech<T_PointCloud>::print()
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitStrategyByAngle DecoderMech<T_PointCloud, T_SplitStrategy>::createSplitStrategy(
+    const SplitStrategyByAngle*)
+{
+  return SplitStrategyByAngle((int32_t)(this->param_.split_angle * 100));
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitStrategyByNum DecoderMech<T_PointCloud, T_SplitStrategy>::createSplitStrategy(
+    const SplitStrategyByNum*)
+{
+  if (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_CUSTOM_BLKS)
+  {
+    return SplitStrategyByNum(this->param_.num_blks_split);
+  }
+
+  return SplitStrategyByNum(this->split_blks_per_frame_);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline void DecoderMech<T_PointCloud, T_SplitStrategy>::updateSplitStrategy(SplitStrategyByNum& strategy)
+{
+  if (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_FIXED_BLKS)
+  {
+    strategy.setMaxBlks(this->split_blks_per_frame_);
+  }
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitStrategyByTime DecoderMech<T_PointCloud, T_SplitStrategy>::createSplitStrategy(
+    const SplitStrategyByTime*)
+{
+  return SplitStrategyByTime(this->param_.split_period);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitFrameMode DecoderMech<T_PointCloud, T_SplitStrategy>::splitMode(
+    const SplitStrategyByAngle*, SplitFrameMode mode)
+{
+  return SplitFrameMode::SPLIT_BY_ANGLE;
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitFrameMode DecoderMech<T_PointCloud, T_SplitStrategy>::splitMode(
+    const SplitStrategyByNum*, SplitFrameMode mode)
+{
+  return (mode == SplitFrameMode::SPLIT_BY_CUSTOM_BLKS) ? mode : SplitFrameMode::SPLIT_BY_FIXED_BLKS;
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline SplitFrameMode DecoderMech<T_PointCloud, T_SplitStrategy>::splitMode(
+    const SplitStrategyByTime*, SplitFrameMode mode)
+{
+  return SplitFrameMode::SPLIT_BY_TIME;
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline size_t DecoderMech<T_PointCloud, T_SplitStrategy>::maxPointsPerFrame(uint16_t split_blks_per_frame)
+{
+  size_t blks = (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_CUSTOM_BLKS) ? 
+    this->param_.num_blks_split : split_blks_per_frame;
+
+  // a time window may cover a part of round, or more than one round.
+  if (this->param_.split_frame_mode == SplitFrameMode::SPLIT_BY_TIME)
+  {
+    blks = (size_t)std::ceil(split_blks_per_frame * this->rps_ * this->param_.split_period);
+  }
+
+  return (size_t)blks * this->const_param_.CHANNELS_PER_BLOCK;
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline size_t DecoderMech<T_PointCloud, T_SplitStrategy>::getMaxPointsPerFrame()
+{
+  return maxPointsPerFrame(this->split_blks_per_frame_);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline size_t DecoderMech<T_PointCloud, T_SplitStrategy>::getMaxPointsPerFrameAnyEcho()
+{
+  return maxPointsPerFrame(std::max(this->split_blks_per_frame_, dualBlksPerFrame()));
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline uint16_t DecoderMech<T_PointCloud, T_SplitStrategy>::dualBlksPerFrame()
+{
+  return (this->blks_per_frame_ << 1);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline void DecoderMech<T_PointCloud, T_SplitStrategy>::setSplitBlksPerFrame(uint16_t split_blks_per_frame)
+{
+  this->split_blks_per_frame_ = split_blks_per_frame;
+  updateSplitStrategy(this->split_strategy_);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline void DecoderMech<T_PointCloud, T_SplitStrategy>::resetSplitStrategy()
+{
+  this->split_strategy_.reset(this->block_az_diff_);
+}
+
+template <typename T_PointCloud, typename T_SplitStrategy>
+inline void DecoderMech<T_PointCloud, T_SplitStrategy>::print()
 {
   std::cout << "-----------------------------------------" << std::endl
     << "rps:\t\t\t" << this->rps_ << std::endl
@@ -165,9 +282,9 @@ inline void DecoderMech<T_PointCloud>::print()
   this->chan_angles_.print();
 }
 
-template <typename T_PointCloud>
+template <typename T_PointCloud, typename T_SplitStrategy>
 template <typename T_Difop>
-inline void DecoderMech<T_PointCloud>::decodeDifopCommon(const T_Difop& pkt)
+inline void DecoderMech<T_PointCloud, T_SplitStrategy>::decodeDifopCommon(const T_Difop& pkt)
 {
   // rounds per second
   this->rps_ = ntohs(pkt.rpm) / 60;
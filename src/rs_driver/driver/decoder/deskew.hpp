@@ -0,0 +1,244 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/common/rs_common.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+
+namespace robosense
+{
+namespace lidar
+{
+
+struct RSPose  ///< Pose of the LiDAR, in a fixed (e.g. odometry) frame
+{
+  double x = 0.0;   ///< unit, m
+  double y = 0.0;   ///< unit, m
+  double z = 0.0;   ///< unit, m
+  double qx = 0.0;  ///< rotation in quaternion
+  double qy = 0.0;
+  double qz = 0.0;
+  double qw = 1.0;
+};
+
+//
+// Timestamped poses pushed by user, e.g. from an IMU or odometry. 
+// interpolate() may be registered as the pose callback of the driver.
+//
+class PoseBuffer
+{
+public:
+
+  PoseBuffer(size_t capacity = 1000)
+    : capacity_(capacity)
+  {
+  }
+
+  void push(double ts, const RSPose& pose)
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    poses_.emplace_back(ts, pose);
+    if (poses_.size() > capacity_)
+    {
+      poses_.pop_front();
+    }
+  }
+
+  //
+  // linear interpolation of position, and normalized linear interpolation of rotation.
+  // false if ts is out of range of the poses.
+  //
+  bool interpolate(double ts, RSPose& pose)
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+
+    if (poses_.empty() || (ts < poses_.front().first) || (ts > poses_.back().first))
+    {
+      return false;
+    }
+
+    auto it = std::lower_bound(poses_.begin(), poses_.end(), ts, 
+        [](const std::pair<double, RSPose>& p, double t) { return p.first < t; });
+    size_t i = (size_t)(it - poses_.begin());
+    if (i == 0)
+    {
+      pose = poses_.front().second;
+      return true;
+    }
+
+    const RSPose& a = poses_[i - 1].second;
+    const RSPose& b = poses_[i].second;
+    double dt = poses_[i].first - poses_[i - 1].first;
+    double w = (dt > 0.0) ? ((ts - poses_[i - 1].first) / dt) : 0.0;
+
+    pose.x = a.x + (b.x - a.x) * w;
+    pose.y = a.y + (b.y - a.y) * w;
+    pose.z = a.z + (b.z - a.z) * w;
+
+    // take the shorter arc
+    double dot = a.qx * b.qx + a.qy * b.qy + a.qz * b.qz + a.qw * b.qw;
+    double sign = (dot < 0.0) ? -1.0 : 1.0;
+    double qx = a.qx + (sign * b.qx - a.qx) * w;
+    double qy = a.qy + (sign * b.qy - a.qy) * w;
+    double qz = a.qz + (sign * b.qz - a.qz) * w;
+    double qw = a.qw + (sign * b.qw - a.qw) * w;
+    double norm = std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+
+    pose.qx = qx / norm;
+    pose.qy = qy / norm;
+    pose.qz = qz / norm;
+    pose.qw = qw / norm;
+    return true;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  size_t capacity_;
+  std::deque<std::pair<double, RSPose>> poses_;
+  std::mutex mtx_;
+};
+
+//
+// Motion compensation of points to the pose at the reference time.
+// Poses are taken at the two ends of a batch, and interpolated linearly for each point between them.
+//
+class Deskew
+{
+public:
+
+  //
+  // save the inverse of the reference pose.
+  //
+  void setReference(const RSPose& pose)
+  {
+    double m[3][4];
+    toMatrix(pose, m);
+
+    // inverse of [R | t] is [R' | -R't]
+    for (int r = 0; r < 3; r++)
+    {
+      for (int c = 0; c < 3; c++)
+      {
+        ref_inv_[r][c] = m[c][r];
+      }
+      ref_inv_[r][3] = -(m[0][r] * m[0][3] + m[1][r] * m[1][3] + m[2][r] * m[2][3]);
+    }
+  }
+
+  //
+  // transform points of time [ts_a, ts_b], with poses pose_a at ts_a and pose_b at ts_b.
+  //
+  void apply(float* xs, float* ys, float* zs, const double* tss, size_t num, 
+      double ts_a, const RSPose& pose_a, double ts_b, const RSPose& pose_b) const
+  {
+    float a[12], d[12];
+    relative(pose_a, a);
+    relative(pose_b, d);
+    for (int i = 0; i < 12; i++)
+    {
+      d[i] -= a[i];
+    }
+
+    double dt = ts_b - ts_a;
+    float scale = (dt > 0.0) ? (float)(1.0 / dt) : 0.0f;
+
+    for (size_t i = 0; i < num; i++)
+    {
+      float w = (float)(tss[i] - ts_a) * scale;
+      float px = xs[i], py = ys[i], pz = zs[i];
+
+      xs[i] = (a[0] + w * d[0]) * px + (a[1] + w * d[1]) * py + (a[2]  + w * d[2])  * pz + (a[3]  + w * d[3]);
+      ys[i] = (a[4] + w * d[4]) * px + (a[5] + w * d[5]) * py + (a[6]  + w * d[6])  * pz + (a[7]  + w * d[7]);
+      zs[i] = (a[8] + w * d[8]) * px + (a[9] + w * d[9]) * py + (a[10] + w * d[10]) * pz + (a[11] + w * d[11]);
+    }
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  static void toMatrix(const RSPose& pose, double m[3][4])
+  {
+    double x = pose.qx, y = pose.qy, z = pose.qz, w = pose.qw;
+
+    m[0][0] = 1 - 2 * (y * y + z * z);
+    m[0][1] = 2 * (x * y - z * w);
+    m[0][2] = 2 * (x * z + y * w);
+    m[0][3] = pose.x;
+
+    m[1][0] = 2 * (x * y + z * w);
+    m[1][1] = 1 - 2 * (x * x + z * z);
+    m[1][2] = 2 * (y * z - x * w);
+    m[1][3] = pose.y;
+
+    m[2][0] = 2 * (x * z - y * w);
+    m[2][1] = 2 * (y * z + x * w);
+    m[2][2] = 1 - 2 * (x * x + y * y);
+    m[2][3] = pose.z;
+  }
+
+  //
+  // ref_inv * pose, in row-major 3 x 4.
+  //
+  void relative(const RSPose& pose, float out[12]) const
+  {
+    double m[3][4];
+    toMatrix(pose, m);
+
+    for (int r = 0; r < 3; r++)
+    {
+      for (int c = 0; c < 4; c++)
+      {
+        double v = ref_inv_[r][0] * m[0][c] + ref_inv_[r][1] * m[1][c] + ref_inv_[r][2] * m[2][c];
+        if (c == 3)
+        {
+          v += ref_inv_[r][3];
+        }
+        out[r * 4 + c] = (float)v;
+      }
+    }
+  }
+
+  double ref_inv_[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+};
+
+}  // namespace lidar
+}  // namespace robosense
@@ -0,0 +1,234 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/driver/driver_param.hpp>
+#include <rs_driver/driver/decoder/point_batch.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Selection of the two returns of a firing in dual return mode, applied to the points of a batch.
+//
+// The two returns of a firing are found as two adjacent groups of points (one per laser, i.e. "stride" points), 
+// with the same rings and timestamps, as the blocks of DualReturnBlockIterator/ABDualReturnBlockIterator, 
+// or the two halves of a RS16 block. Points without a partner are kept as they are.
+//
+// DUAL_RETURN_STRONGEST/LAST/FIRST keep one group of points per firing, so the point cloud is as large as 
+// in single return mode. DUAL_RETURN_DEDUPE turns the second return into a NAN point, if it is at the same 
+// distance as the first one. DUAL_RETURN_SPLIT moves the second return into another batch, aligned point by point
+// with the first one, i.e. with a NAN point for each point without a partner.
+//
+class DualReturnFilter
+{
+public:
+
+  DualReturnFilter(DualReturnMode mode, float tolerance)
+    : mode_(mode), tolerance_(tolerance), stride_(0)
+  {
+  }
+
+  void setStride(uint16_t stride)
+  {
+    stride_ = stride;
+  }
+
+  bool enabled() const
+  {
+    return (mode_ != DUAL_RETURN_ALL) && (stride_ > 0);
+  }
+
+  bool splitting() const
+  {
+    return (mode_ == DUAL_RETURN_SPLIT);
+  }
+
+  // one return of each firing is left in the batch, so it has half the points of the two returns.
+  bool halving() const
+  {
+    return enabled() && (mode_ != DUAL_RETURN_DEDUPE);
+  }
+
+  void split(PointBatch& batch, PointBatch& echo) const
+  {
+    size_t num = batch.size_;
+    size_t dst = 0;
+    size_t p = 0;
+
+    while (p < num)
+    {
+      bool pair = paired(batch, p);
+      size_t end = std::min(p + stride_, num);
+
+      for (size_t a = p; a < end; a++, dst++)
+      {
+        if (pair)
+        {
+          size_t b = a + stride_;
+          echo.push(batch.xs_[b], batch.ys_[b], batch.zs_[b], batch.intensities_[b], batch.timestamps_[b], 
+              batch.rings_[b], batch.distances_[b], batch.azimuths_[b], batch.elevations_[b]);
+        }
+        else
+        {
+          echo.pushNan(batch.timestamps_[a], batch.rings_[a]);
+        }
+
+        batch.move(dst, a);
+      }
+
+      p += (pair ? (stride_ * 2) : stride_);
+    }
+
+    batch.size_ = dst;
+  }
+
+  void apply(PointBatch& batch) const
+  {
+    size_t num = batch.size_;
+    size_t dst = 0;
+    size_t p = 0;
+
+    while (p < num)
+    {
+      if (!paired(batch, p))
+      {
+        size_t end = std::min(p + stride_, num);
+        for (; p < end; p++, dst++)
+        {
+          batch.move(dst, p);
+        }
+
+        continue;
+      }
+
+      if (mode_ == DUAL_RETURN_DEDUPE)
+      {
+        for (size_t k = 0; k < stride_; k++)
+        {
+          batch.move(dst + k, p + k);
+          batch.move(dst + stride_ + k, p + stride_ + k);
+
+          size_t b = dst + stride_ + k;
+          if ((batch.distances_[b] > 0.0f) && 
+              (std::fabs(batch.distances_[b] - batch.distances_[dst + k]) <= tolerance_))
+          {
+            batch.xs_[b] = batch.ys_[b] = batch.zs_[b] = NAN;
+            batch.intensities_[b] = 0;
+            batch.distances_[b] = 0.0f;
+          }
+        }
+
+        dst += stride_ * 2;
+      }
+      else
+      {
+        for (size_t k = 0; k < stride_; k++)
+        {
+          size_t a = p + k;
+          size_t b = p + stride_ + k;
+          batch.move(dst + k, select(batch, a, b) ? a : b);
+        }
+
+        dst += stride_;
+      }
+
+      p += stride_ * 2;
+    }
+
+    batch.size_ = dst;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  bool paired(const PointBatch& batch, size_t p) const
+  {
+    if (p + stride_ * 2 > batch.size_)
+    {
+      return false;
+    }
+
+    for (size_t k = 0; k < stride_; k++)
+    {
+      if ((batch.rings_[p + k] != batch.rings_[p + stride_ + k]) || 
+          (batch.timestamps_[p + k] != batch.timestamps_[p + stride_ + k]))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  // true: keep a; false: keep b. invalid points (distance 0) are never preferred.
+  bool select(const PointBatch& batch, size_t a, size_t b) const
+  {
+    float dist_a = batch.distances_[a];
+    float dist_b = batch.distances_[b];
+
+    if (dist_a <= 0.0f)
+    {
+      return false;
+    }
+    else if (dist_b <= 0.0f)
+    {
+      return true;
+    }
+
+    switch (mode_)
+    {
+      case DUAL_RETURN_STRONGEST:
+        return (batch.intensities_[a] >= batch.intensities_[b]);
+      case DUAL_RETURN_LAST:
+        return (dist_a >= dist_b);
+      case DUAL_RETURN_FIRST:
+      default:
+        return (dist_a <= dist_b);
+    }
+  }
+
+  DualReturnMode mode_;
+  float tolerance_;
+  size_t stride_; // points of one return of a firing
+};
+
+}  // namespace lidar
+}  // namespace robosense
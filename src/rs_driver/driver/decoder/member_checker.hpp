@@ -32,6 +32,10 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
 #define DEFINE_MEMBER_CHECKER(member)                                                                                  \
   template <typename T, typename V = bool>                                                                             \
   struct has_##member : std::false_type                                                                                \
@@ -51,41 +55,162 @@ DEFINE_MEMBER_CHECKER(intensity)
 DEFINE_MEMBER_CHECKER(ring)
 DEFINE_MEMBER_CHECKER(timestamp)
 
+DEFINE_MEMBER_CHECKER(points)
+DEFINE_MEMBER_CHECKER(xs)
+DEFINE_MEMBER_CHECKER(ys)
+DEFINE_MEMBER_CHECKER(zs)
+DEFINE_MEMBER_CHECKER(intensities)
+DEFINE_MEMBER_CHECKER(rings)
+DEFINE_MEMBER_CHECKER(timestamps)
+
+DEFINE_MEMBER_CHECKER(distances)
+DEFINE_MEMBER_CHECKER(col_timestamps)
+
+DEFINE_MEMBER_CHECKER(xyz_res)
+DEFINE_MEMBER_CHECKER(ts_offset)
+DEFINE_MEMBER_CHECKER(ts_offset_ns)
+DEFINE_MEMBER_CHECKER(ts_offsets)
+
 #define RS_HAS_MEMBER(C, member) has_##member<C>::value
 
+//
+// check member of the point type of a cloud, e.g. PointCloudT<PointXYZIRT>. false if the cloud has no points.
+//
+#define DEFINE_POINT_MEMBER_CHECKER(member)                                                                            \
+  template <typename T, typename V = bool>                                                                             \
+  struct has_point_##member : std::false_type                                                                          \
+  {                                                                                                                    \
+  };                                                                                                                   \
+  template <typename T>                                                                                                \
+  struct has_point_##member<                                                                                           \
+      T, typename std::enable_if<!std::is_same<decltype(std::declval<T>().points[0].member), void>::value, bool>::type>\
+      : std::true_type                                                                                                 \
+  {                                                                                                                    \
+  };
+
+DEFINE_POINT_MEMBER_CHECKER(ts_offset)
+DEFINE_POINT_MEMBER_CHECKER(ts_offset_ns)
+DEFINE_POINT_MEMBER_CHECKER(xyz_res)
+
+#define RS_POINT_HAS_MEMBER(C, member) has_point_##member<C>::value
+
+//
+// quantize a coordinate into an integer of res, e.g. int16_t of 5 mm.
+// The minimum of the integer is reserved for invalid points, i.e. NAN or out of range.
+//
+template <typename T_Value>
+constexpr T_Value quantizedNan()
+{
+  return std::numeric_limits<T_Value>::min();
+}
+
+template <typename T_Value>
+inline bool quantizable(float value, float res)
+{
+  double q = (double)value / res; // false if NAN
+  return ((double)std::numeric_limits<T_Value>::min() + 0.5 <= q) &&
+    (q < (double)std::numeric_limits<T_Value>::max() + 0.5);
+}
+
+template <typename T_Value>
+inline T_Value quantize(float value, float res)
+{
+  if (!quantizable<T_Value>(value, res))
+  {
+    return quantizedNan<T_Value>();
+  }
+
+  float q = value / res;
+  q += (q >= 0.0f) ? 0.5f : -0.5f;
+  return (T_Value)q;
+}
+
 template <typename T_Point>
 inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, x)>::type setX(T_Point& point, const float& value)
 {
 }
 
 template <typename T_Point>
-inline typename std::enable_if<RS_HAS_MEMBER(T_Point, x)>::type setX(T_Point& point, const float& value)
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, x) && !RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setX(T_Point& point, const float& value)
 {
   point.x = value;
 }
 
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, x) && RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setX(T_Point& point, const float& value)
+{
+  point.x = quantize<decltype(point.x)>(value, T_Point::xyz_res);
+}
+
 template <typename T_Point>
 inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, y)>::type setY(T_Point& point, const float& value)
 {
 }
 
 template <typename T_Point>
-inline typename std::enable_if<RS_HAS_MEMBER(T_Point, y)>::type setY(T_Point& point, const float& value)
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, y) && !RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setY(T_Point& point, const float& value)
 {
   point.y = value;
 }
 
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, y) && RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setY(T_Point& point, const float& value)
+{
+  point.y = quantize<decltype(point.y)>(value, T_Point::xyz_res);
+}
+
 template <typename T_Point>
 inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, z)>::type setZ(T_Point& point, const float& value)
 {
 }
 
 template <typename T_Point>
-inline typename std::enable_if<RS_HAS_MEMBER(T_Point, z)>::type setZ(T_Point& point, const float& value)
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, z) && !RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setZ(T_Point& point, const float& value)
 {
   point.z = value;
 }
 
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, z) && RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setZ(T_Point& point, const float& value)
+{
+  point.z = quantize<decltype(point.z)>(value, T_Point::xyz_res);
+}
+
+//
+// a point of quantized coordinates is invalid as a whole, if any coordinate is.
+//
+template <typename T_Point>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setXYZ(T_Point& point, float x, float y, float z)
+{
+  setX(point, x);
+  setY(point, y);
+  setZ(point, z);
+}
+
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, xyz_res)>::type
+setXYZ(T_Point& point, float x, float y, float z)
+{
+  typedef decltype(point.x) T_Value;
+  if (!quantizable<T_Value>(x, T_Point::xyz_res) || !quantizable<T_Value>(y, T_Point::xyz_res) || 
+      !quantizable<T_Value>(z, T_Point::xyz_res))
+  {
+    point.x = point.y = point.z = quantizedNan<T_Value>();
+    return;
+  }
+
+  setX(point, x);
+  setY(point, y);
+  setZ(point, z);
+}
+
 template <typename T_Point>
 inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, intensity)>::type setIntensity(T_Point& point,
                                                                                       const uint8_t& value)
@@ -123,3 +248,278 @@ inline typename std::enable_if<RS_HAS_MEMBER(T_Point, timestamp)>::type setTimes
   point.timestamp = value;
 }
 
+//
+// timestamp offset of point to the timestamp of point cloud, in second (float) or nanosecond (uint32_t).
+//
+template <typename T_Point>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, ts_offset)>::type setTsOffset(T_Point& point,
+                                                                                     const double& value)
+{
+}
+
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, ts_offset)>::type setTsOffset(T_Point& point,
+                                                                                    const double& value)
+{
+  point.ts_offset = (float)value;
+}
+
+template <typename T_Point>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_Point, ts_offset_ns)>::type setTsOffsetNs(T_Point& point,
+                                                                                          const double& value)
+{
+}
+
+template <typename T_Point>
+inline typename std::enable_if<RS_HAS_MEMBER(T_Point, ts_offset_ns)>::type setTsOffsetNs(T_Point& point,
+                                                                                         const double& value)
+{
+  point.ts_offset_ns = (value > 0.0) ? (uint32_t)(value * 1e9 + 0.5) : 0;
+}
+
+//
+// point cloud in layout of structure-of-arrays, e.g. PointCloudSoA.
+//
+
+#define DEFINE_ARRAY_ACCESSOR(name, member, T_Value)                                                                   \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, member)>::type push##name(T_PointCloud& cloud,           \
+                                                                                  const T_Value& value)                \
+  {                                                                                                                    \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, member)>::type push##name(T_PointCloud& cloud,            \
+                                                                                 const T_Value& value)                 \
+  {                                                                                                                    \
+    cloud.member.push_back(value);                                                                                     \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, member)>::type set##name##At(T_PointCloud& cloud,        \
+                                                                                      size_t idx, const T_Value& value)\
+  {                                                                                                                    \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, member)>::type set##name##At(T_PointCloud& cloud,         \
+                                                                                     size_t idx, const T_Value& value) \
+  {                                                                                                                    \
+    cloud.member[idx] = value;                                                                                         \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, member)>::type append##name(T_PointCloud& dst,           \
+                                                                      const T_PointCloud& src, size_t from, size_t to) \
+  {                                                                                                                    \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, member)>::type append##name(T_PointCloud& dst,            \
+                                                                      const T_PointCloud& src, size_t from, size_t to) \
+  {                                                                                                                    \
+    dst.member.insert(dst.member.end(), src.member.begin() + from, src.member.begin() + to);                           \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, member)>::type move##name##At(T_PointCloud& cloud,       \
+                                                                                   size_t dst, size_t src)             \
+  {                                                                                                                    \
+  }                                                                                                                    \
+  template <typename T_PointCloud>                                                                                     \
+  inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, member)>::type move##name##At(T_PointCloud& cloud,        \
+                                                                                  size_t dst, size_t src)              \
+  {                                                                                                                    \
+    cloud.member[dst] = cloud.member[src];                                                                             \
+  }
+
+DEFINE_ARRAY_ACCESSOR(X, xs, float)
+DEFINE_ARRAY_ACCESSOR(Y, ys, float)
+DEFINE_ARRAY_ACCESSOR(Z, zs, float)
+DEFINE_ARRAY_ACCESSOR(Intensity, intensities, uint8_t)
+DEFINE_ARRAY_ACCESSOR(Ring, rings, uint16_t)
+DEFINE_ARRAY_ACCESSOR(Timestamp, timestamps, double)
+DEFINE_ARRAY_ACCESSOR(TsOffset, ts_offsets, float)
+
+//
+// whether a point can be saved in the cloud. Quantized coordinates have to be in range too.
+//
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_POINT_HAS_MEMBER(T_PointCloud, xyz_res), bool>::type isValidPoint(
+    float x, float y, float z)
+{
+  return !std::isnan(x);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_POINT_HAS_MEMBER(T_PointCloud, xyz_res), bool>::type isValidPoint(
+    float x, float y, float z)
+{
+  typedef typename T_PointCloud::PointT T_Point;
+  typedef decltype(T_Point::x) T_Value;
+  return quantizable<T_Value>(x, T_Point::xyz_res) && quantizable<T_Value>(y, T_Point::xyz_res) &&
+    quantizable<T_Value>(z, T_Point::xyz_res);
+}
+
+//
+// add a point to the cloud, whether it is an array of points, or structure-of-arrays.
+// ts_base is the timestamp of the cloud, for points which save timestamp offset.
+//
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type addPoint(T_PointCloud& cloud, 
+    float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring, double ts_base = 0.0)
+{
+  typename T_PointCloud::PointT point;
+  setXYZ(point, x, y, z);
+  setIntensity(point, intensity);
+  setTimestamp(point, timestamp);
+  setTsOffset(point, timestamp - ts_base);
+  setTsOffsetNs(point, timestamp - ts_base);
+  setRing(point, ring);
+
+  cloud.points.emplace_back(point);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type addPoint(T_PointCloud& cloud, 
+    float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring, double ts_base = 0.0)
+{
+  pushX(cloud, x);
+  pushY(cloud, y);
+  pushZ(cloud, z);
+  pushIntensity(cloud, intensity);
+  pushTimestamp(cloud, timestamp);
+  pushTsOffset(cloud, (float)(timestamp - ts_base));
+  pushRing(cloud, ring);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type setPointAt(T_PointCloud& cloud, size_t idx,
+    float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring, double ts_base = 0.0)
+{
+  typename T_PointCloud::PointT& point = cloud.points[idx];
+  setXYZ(point, x, y, z);
+  setIntensity(point, intensity);
+  setTimestamp(point, timestamp);
+  setTsOffset(point, timestamp - ts_base);
+  setTsOffsetNs(point, timestamp - ts_base);
+  setRing(point, ring);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type setPointAt(T_PointCloud& cloud, size_t idx,
+    float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring, double ts_base = 0.0)
+{
+  setXAt(cloud, idx, x);
+  setYAt(cloud, idx, y);
+  setZAt(cloud, idx, z);
+  setIntensityAt(cloud, idx, intensity);
+  setTimestampAt(cloud, idx, timestamp);
+  setTsOffsetAt(cloud, idx, (float)(timestamp - ts_base));
+  setRingAt(cloud, idx, ring);
+}
+
+//
+// move the point at src of the cloud to dst, e.g. to re-layout an organized point cloud.
+//
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type movePointAt(T_PointCloud& cloud, 
+    size_t dst, size_t src)
+{
+  cloud.points[dst] = cloud.points[src];
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type movePointAt(T_PointCloud& cloud, 
+    size_t dst, size_t src)
+{
+  moveXAt(cloud, dst, src);
+  moveYAt(cloud, dst, src);
+  moveZAt(cloud, dst, src);
+  moveIntensityAt(cloud, dst, src);
+  moveRingAt(cloud, dst, src);
+  moveTimestampAt(cloud, dst, src);
+  moveTsOffsetAt(cloud, dst, src);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points), size_t>::type pointNum(const T_PointCloud& cloud)
+{
+  return cloud.points.size();
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points), size_t>::type pointNum(const T_PointCloud& cloud)
+{
+  return cloud.size();
+}
+
+//
+// append points [from, to) of src to dst, e.g. a sector of the frame. dst is reserved first, so it grows only once.
+//
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type appendPoints(T_PointCloud& dst,
+    const T_PointCloud& src, size_t from, size_t to)
+{
+  if (to <= from)
+  {
+    return;
+  }
+
+  dst.points.reserve(dst.points.size() + (to - from));
+  dst.points.insert(dst.points.end(), src.points.begin() + from, src.points.begin() + to);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type appendPoints(T_PointCloud& dst,
+    const T_PointCloud& src, size_t from, size_t to)
+{
+  if (to <= from)
+  {
+    return;
+  }
+
+  dst.reserve(pointNum(dst) + (to - from));
+  appendX(dst, src, from, to);
+  appendY(dst, src, from, to);
+  appendZ(dst, src, from, to);
+  appendIntensity(dst, src, from, to);
+  appendRing(dst, src, from, to);
+  appendTimestamp(dst, src, from, to);
+  appendTsOffset(dst, src, from, to);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type clearPoints(T_PointCloud& cloud)
+{
+  cloud.points.clear();
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type clearPoints(T_PointCloud& cloud)
+{
+  cloud.clear();
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type reservePoints(T_PointCloud& cloud, 
+    size_t num)
+{
+  cloud.points.reserve(num);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type reservePoints(T_PointCloud& cloud, 
+    size_t num)
+{
+  cloud.reserve(num);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<RS_HAS_MEMBER(T_PointCloud, points)>::type resizePoints(T_PointCloud& cloud, 
+    size_t num)
+{
+  cloud.points.resize(num);
+}
+
+template <typename T_PointCloud>
+inline typename std::enable_if<!RS_HAS_MEMBER(T_PointCloud, points)>::type resizePoints(T_PointCloud& cloud, 
+    size_t num)
+{
+  cloud.resize(num);
+}
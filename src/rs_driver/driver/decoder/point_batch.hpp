@@ -0,0 +1,163 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/common/rs_common.hpp>
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Points of one MSOP packet, staged in separate arrays before they are written into the point cloud.
+// The storage grows to the packet size once, and is reused for the following packets.
+//
+// Besides xyz, the polar measurement (distance, azimuth, elevation) is kept, for clouds
+// which are not built on xyz, such as the range image.
+//
+class PointBatch
+{
+public:
+
+  constexpr static int32_t ANGLE_UNKNOWN = INT32_MIN; // lidars which give no angles, such as RSE1/RSM2
+
+  PointBatch()
+    : size_(0), skip_nan_(false)
+  {
+  }
+
+  //
+  // don't stage invalid points at all, if they are to be dropped anyway, i.e. dense points.
+  //
+  void setSkipNan(bool skip)
+  {
+    skip_nan_ = skip;
+  }
+
+  void push(float x, float y, float z, uint8_t intensity, double timestamp, uint16_t ring,
+      float distance = 0.0f, int32_t azimuth = ANGLE_UNKNOWN, int32_t elevation = ANGLE_UNKNOWN)
+  {
+    if (size_ >= xs_.size())
+    {
+      grow();
+    }
+
+    xs_[size_] = x;
+    ys_[size_] = y;
+    zs_[size_] = z;
+    intensities_[size_] = intensity;
+    timestamps_[size_] = timestamp;
+    rings_[size_] = ring;
+    distances_[size_] = distance;
+    azimuths_[size_] = azimuth;
+    elevations_[size_] = elevation;
+    size_++;
+  }
+
+  void pushNan(double timestamp, uint16_t ring)
+  {
+    if (skip_nan_)
+    {
+      return;
+    }
+
+    push(NAN, NAN, NAN, 0, timestamp, ring, 0.0f, ANGLE_UNKNOWN, ANGLE_UNKNOWN);
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  void clear()
+  {
+    size_ = 0;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  template <typename T_PointCloud>
+  friend class Decoder;
+  friend class DualReturnFilter;
+
+  void grow()
+  {
+    size_t capacity = (xs_.size() == 0) ? 128 : (xs_.size() * 2);
+
+    xs_.resize(capacity);
+    ys_.resize(capacity);
+    zs_.resize(capacity);
+    intensities_.resize(capacity);
+    timestamps_.resize(capacity);
+    rings_.resize(capacity);
+    distances_.resize(capacity);
+    azimuths_.resize(capacity);
+    elevations_.resize(capacity);
+  }
+
+  void move(size_t dst, size_t src)
+  {
+    xs_[dst] = xs_[src];
+    ys_[dst] = ys_[src];
+    zs_[dst] = zs_[src];
+    intensities_[dst] = intensities_[src];
+    timestamps_[dst] = timestamps_[src];
+    rings_[dst] = rings_[src];
+    distances_[dst] = distances_[src];
+    azimuths_[dst] = azimuths_[src];
+    elevations_[dst] = elevations_[src];
+  }
+
+  size_t size_;
+  bool skip_nan_;
+  std::vector<float> xs_;
+  std::vector<float> ys_;
+  std::vector<float> zs_;
+  std::vector<uint8_t> intensities_;
+  std::vector<double> timestamps_;
+  std::vector<uint16_t> rings_;
+  std::vector<float> distances_; // 0 for invalid points
+  std::vector<int32_t> azimuths_; // in 0.01 degree, clockwise as mechanical lidars
+  std::vector<int32_t> elevations_; // in 0.01 degree
+};
+
+}  // namespace lidar
+}  // namespace robosense
@@ -0,0 +1,218 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/driver/driver_param.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Region-of-interest filter evaluated on the points, before they are written into the point cloud.
+//
+// The ring/azimuth mask marks the (ring, azimuth bin) cells blocked by the vehicle body. The decoders test it 
+// per channel, before calculating xyz. The crop boxes are evaluated on the points of a batch. 
+// The crop boxes keep or drop the points inside. Boxes of the same frame (LiDAR frame or transformed frame) are 
+// evaluated together: a point is kept if it is inside any of the include boxes (or there is no include box),
+// and outside all of the exclude boxes.
+//
+// Rejected points are turned into NAN points, so they are discarded or reserved the same way as 
+// the points out of the distance range.
+//
+class RoiFilter
+{
+public:
+
+  RoiFilter(const std::vector<RSCropBox>& boxes, const RSRingAzimuthMask& mask)
+    : azimuth_bins_(mask.azimuth_bins)
+    , rings_(0)
+    , has_include_{false, false}
+  {
+    for (const auto& b : boxes)
+    {
+      Box box;
+      box.x = b.x;
+      box.y = b.y;
+      box.z = b.z;
+      box.half_length = b.length / 2;
+      box.half_width = b.width / 2;
+      box.half_height = b.height / 2;
+      box.cos_yaw = std::cos(b.yaw);
+      box.sin_yaw = std::sin(b.yaw);
+      box.include = b.include;
+
+      int f = b.transformed ? 1 : 0;
+      boxes_[f].push_back(box);
+      has_include_[f] = has_include_[f] || b.include;
+    }
+
+    if ((azimuth_bins_ > 0) && (mask.masked.size() >= azimuth_bins_))
+    {
+      rings_ = (uint16_t)(mask.masked.size() / azimuth_bins_);
+
+      bits_.resize((mask.masked.size() + 63) / 64, 0);
+      for (size_t i = 0; i < mask.masked.size(); i++)
+      {
+        if (mask.masked[i])
+        {
+          bits_[i >> 6] |= ((uint64_t)1 << (i & 63));
+        }
+      }
+    }
+  }
+
+  bool hasMask() const
+  {
+    return (rings_ > 0);
+  }
+
+  bool hasBoxes(bool transformed) const
+  {
+    return !boxes_[transformed ? 1 : 0].empty();
+  }
+
+  //
+  // azimuth in 0.01 degree. Rings out of the mask, including all rings if there is no mask, are not masked.
+  //
+  bool masked(uint16_t ring, int32_t azimuth) const
+  {
+    if (ring >= rings_)
+    {
+      return false;
+    }
+
+    int32_t azi = azimuth % 36000;
+    if (azi < 0)
+    {
+      azi += 36000;
+    }
+
+    size_t cell = (size_t)ring * azimuth_bins_ + (size_t)azi * azimuth_bins_ / 36000;
+    return (bits_[cell >> 6] & ((uint64_t)1 << (cell & 63))) != 0;
+  }
+
+  void applyBoxes(bool transformed, 
+      float* xs, float* ys, float* zs, uint8_t* intensities, float* distances, size_t num) const
+  {
+    int f = transformed ? 1 : 0;
+    const std::vector<Box>& boxes = boxes_[f];
+
+    for (size_t i = 0; i < num; i++)
+    {
+      if (std::isnan(xs[i]))
+      {
+        continue;
+      }
+
+      bool included = !has_include_[f];
+      bool excluded = false;
+
+      for (const auto& box : boxes)
+      {
+        if (box.include && included)
+        {
+          continue; // already inside an include box
+        }
+
+        if (inside(box, xs[i], ys[i], zs[i]))
+        {
+          if (box.include)
+          {
+            included = true;
+          }
+          else
+          {
+            excluded = true;
+            break;
+          }
+        }
+      }
+
+      if (!included || excluded)
+      {
+        reject(i, xs, ys, zs, intensities, distances);
+      }
+    }
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  struct Box
+  {
+    float x, y, z;
+    float half_length, half_width, half_height;
+    float cos_yaw, sin_yaw;
+    bool include;
+  };
+
+  static bool inside(const Box& box, float x, float y, float z)
+  {
+    float dx = x - box.x;
+    float dy = y - box.y;
+    float dz = z - box.z;
+
+    // rotate into the box frame
+    float lx =  box.cos_yaw * dx + box.sin_yaw * dy;
+    float ly = -box.sin_yaw * dx + box.cos_yaw * dy;
+
+    return (std::fabs(lx) <= box.half_length) && (std::fabs(ly) <= box.half_width) && 
+      (std::fabs(dz) <= box.half_height);
+  }
+
+  static void reject(size_t i, float* xs, float* ys, float* zs, uint8_t* intensities, float* distances)
+  {
+    xs[i] = NAN;
+    ys[i] = NAN;
+    zs[i] = NAN;
+    intensities[i] = 0;
+    distances[i] = 0.0f;
+  }
+
+  uint16_t azimuth_bins_;
+  uint16_t rings_;
+  std::vector<uint64_t> bits_; // ring x azimuth_bins_ bits, 1 for masked cells
+  std::vector<Box> boxes_[2]; // [0]: in LiDAR frame, [1]: in transformed frame
+  bool has_include_[2];
+};
+
+}  // namespace lidar
+}  // namespace robosense
@@ -64,6 +64,11 @@ public:
     }
   }
 
+  bool fullRound() const
+  {
+    return full_round_;
+  }
+
 #ifndef UNIT_TEST
 private:
 #endif
@@ -32,19 +32,20 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+
 namespace robosense
 {
 namespace lidar
 {
 
-class SplitStrategy
-{
-public:
-  virtual bool newBlock(int32_t angle) = 0;
-  virtual ~SplitStrategy() = default;
-};
+//
+// split strategies of mechanical lidars. They are used as a template parameter 
+// of DecoderMech, so newBlock() is inlined into the decoding loop.
+//
 
-class SplitStrategyByAngle : public SplitStrategy
+class SplitStrategyByAngle
 {
 public:
   SplitStrategyByAngle (int32_t split_angle)
@@ -52,9 +53,19 @@ public:
   {
   }
 
-  virtual ~SplitStrategyByAngle() = default;
+  //
+  // forget the previous block. The block before the next one is then assumed 
+  // to be block_az_diff behind it, so a packet may be split on its own.
+  //
+  // The previous angle is seeded to be block_az_diff after split_angle, so that
+  // the next block splits only if its angle is in [split_angle, split_angle + block_az_diff).
+  //
+  void reset(int32_t block_az_diff)
+  {
+    prev_angle_ = split_angle_ + block_az_diff;
+  }
 
-  virtual bool newBlock(int32_t angle)
+  bool newBlock(int32_t angle, double)
   {
     if (angle < prev_angle_)
     {
@@ -80,20 +91,33 @@ private:
     int32_t prev_angle_;
 };
 
-class SplitStrategyByNum : public SplitStrategy
+class SplitStrategyByNum
 {
 public:
-  SplitStrategyByNum (uint16_t* max_blks)
+  SplitStrategyByNum (uint16_t max_blks)
    : max_blks_(max_blks), blks_(0)
   {
   }
 
-  virtual ~SplitStrategyByNum() = default;
+  //
+  // the decoder calls it when the blocks per frame change, e.g. with the echo mode in DIFOP packets.
+  //
+  void setMaxBlks(uint16_t max_blks)
+  {
+    max_blks_ = max_blks;
+  }
+
+  //
+  // blocks are counted across packets, so there is nothing to forget.
+  //
+  void reset(int32_t)
+  {
+  }
 
-  virtual bool newBlock(int32_t)
+  bool newBlock(int32_t, double)
   {
     blks_++;
-    if (blks_ >= *max_blks_)
+    if (blks_ >= max_blks_)
     {
       blks_ = 0;
       return true;
@@ -105,10 +129,63 @@ public:
 #ifndef UNIT_TEST
 private:
 #endif
-  uint16_t* max_blks_;
+  uint16_t max_blks_;
   uint16_t blks_;
 };
 
+//
+// split frames on boundaries of absolute time, i.e. multiples of period since the epoch,
+// so that frames of different lidars cover the same time windows.
+//
+class SplitStrategyByTime
+{
+public:
+  SplitStrategyByTime (double period)
+   : period_(period), prev_slot_(-1)
+  {
+  }
+
+  void reset(int32_t)
+  {
+  }
+
+  bool newBlock(int32_t, double ts)
+  {
+    return newTime(ts);
+  }
+
+  //
+  // like SplitStrategyBySeq, a block a little older than the current slot, e.g. of a reordered packet, 
+  // is ignored. Only time going back far, e.g. a PCAP file played again, is a rewind.
+  //
+  bool newTime(double ts)
+  {
+    int64_t slot = (int64_t)std::floor(ts / period_);
+    if (slot == prev_slot_)
+    {
+      return false;
+    }
+
+    if ((slot < prev_slot_) && ((prev_slot_ - slot) * period_ <= REWIND))
+    {
+      return false;
+    }
+
+    bool v = (prev_slot_ >= 0);
+    prev_slot_ = slot;
+    return v;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  constexpr static double REWIND = 1.0; // in second
+
+  double period_;
+  int64_t prev_slot_;
+};
+
 class SplitStrategyBySeq
 {
 public:
@@ -0,0 +1,121 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/common/rs_common.hpp>
+#include <rs_driver/driver/driver_param.hpp>
+
+#include <cmath>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Affine transform (rotation yaw - pitch - roll, then translation) in single precision.
+// The all-zero param is detected as identity, and then the decoder skips the transform stage.
+//
+class Transform
+{
+public:
+
+  Transform(const RSTransformParam& param)
+  {
+    identity_ = (param.x == 0.0f) && (param.y == 0.0f) && (param.z == 0.0f) && 
+      (param.roll == 0.0f) && (param.pitch == 0.0f) && (param.yaw == 0.0f);
+
+    double cr = std::cos(param.roll), sr = std::sin(param.roll);
+    double cp = std::cos(param.pitch), sp = std::sin(param.pitch);
+    double cy = std::cos(param.yaw), sy = std::sin(param.yaw);
+
+    // R = Rz(yaw) * Ry(pitch) * Rx(roll)
+    m_[0][0] = (float)(cy * cp);
+    m_[0][1] = (float)(cy * sp * sr - sy * cr);
+    m_[0][2] = (float)(cy * sp * cr + sy * sr);
+    m_[0][3] = param.x;
+
+    m_[1][0] = (float)(sy * cp);
+    m_[1][1] = (float)(sy * sp * sr + cy * cr);
+    m_[1][2] = (float)(sy * sp * cr - cy * sr);
+    m_[1][3] = param.y;
+
+    m_[2][0] = (float)(-sp);
+    m_[2][1] = (float)(cp * sr);
+    m_[2][2] = (float)(cp * cr);
+    m_[2][3] = param.z;
+  }
+
+  bool isIdentity() const
+  {
+    return identity_;
+  }
+
+  void apply(float& x, float& y, float& z) const
+  {
+    float px = x, py = y, pz = z;
+    x = m_[0][0] * px + m_[0][1] * py + m_[0][2] * pz + m_[0][3];
+    y = m_[1][0] * px + m_[1][1] * py + m_[1][2] * pz + m_[1][3];
+    z = m_[2][0] * px + m_[2][1] * py + m_[2][2] * pz + m_[2][3];
+  }
+
+  //
+  // Apply to a batch of points. The loop has no branches and works on separate x/y/z arrays,
+  // so the compiler can vectorize it. NAN points stay NAN.
+  //
+  void apply(float* xs, float* ys, float* zs, size_t num) const
+  {
+    const float m00 = m_[0][0], m01 = m_[0][1], m02 = m_[0][2], m03 = m_[0][3];
+    const float m10 = m_[1][0], m11 = m_[1][1], m12 = m_[1][2], m13 = m_[1][3];
+    const float m20 = m_[2][0], m21 = m_[2][1], m22 = m_[2][2], m23 = m_[2][3];
+
+    for (size_t i = 0; i < num; i++)
+    {
+      float px = xs[i], py = ys[i], pz = zs[i];
+      xs[i] = m00 * px + m01 * py + m02 * pz + m03;
+      ys[i] = m10 * px + m11 * py + m12 * pz + m13;
+      zs[i] = m20 * px + m21 * py + m22 * pz + m23;
+    }
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  bool identity_;
+  float m_[3][4];
+};
+
+}  // namespace lidar
+}  // namespace robosense
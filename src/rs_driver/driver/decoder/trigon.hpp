@@ -77,6 +77,16 @@ public:
     coss_ = o_coss_ - ANGLE_MIN;
   }
 
+  //
+  // the table is read-only once built, so all decoders share one instance.
+  // it is built on the first call.
+  //
+  static const Trigon& instance()
+  {
+    static const Trigon trigon;
+    return trigon;
+  }
+
   ~Trigon()
   {
     free(o_coss_);
@@ -86,7 +96,7 @@ public:
 #endif
   }
 
-  float sin(int32_t angle)
+  float sin(int32_t angle) const
   {
     if (angle < ANGLE_MIN || angle >= ANGLE_MAX)
     {
@@ -96,7 +106,7 @@ public:
     return sins_[angle];
   }
 
-  float cos(int32_t angle)
+  float cos(int32_t angle) const
   {
     if (angle < ANGLE_MIN || angle >= ANGLE_MAX)
     {
@@ -106,7 +116,7 @@ public:
     return coss_[angle];
   }
 
-  void print()
+  void print() const
   {
     for (int32_t i = -10; i < 10; i++)
     {
@@ -129,5 +139,74 @@ private:
   float* coss_;
 };
 
+//
+// TrigonCompact keeps only a quarter wave of sin(), i.e. [0, 90] degree, 
+// about 36KB instead of 432KB of Trigon, so that it stays in cache.
+// Other angles are folded into the quarter wave with a few integer operations.
+//
+class TrigonCompact
+{
+public:
+
+  constexpr static int32_t ANGLE_MIN = -9000;
+  constexpr static int32_t ANGLE_MAX = 45000;
+  constexpr static int32_t QUARTER = 9000;
+  constexpr static int32_t ROUND = 36000;
+
+  TrigonCompact()
+  {
+    for (int32_t i = 0; i <= QUARTER; i++)
+    {
+      double rad = DEGREE_TO_RADIAN(static_cast<double>(i) * 0.01);
+      sins_[i] = (float)std::sin(rad);
+    }
+  }
+
+  static const TrigonCompact& instance()
+  {
+    static const TrigonCompact trigon;
+    return trigon;
+  }
+
+  float sin(int32_t angle) const
+  {
+    if (angle < ANGLE_MIN || angle >= ANGLE_MAX)
+    {
+      angle = 0;
+    }
+
+    return foldSin(angle);
+  }
+
+  float cos(int32_t angle) const
+  {
+    if (angle < ANGLE_MIN || angle >= ANGLE_MAX)
+    {
+      angle = 0;
+    }
+
+    return foldSin(angle + QUARTER);
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  // angle should be in [-ROUND, 2 * ROUND)
+  float foldSin(int32_t angle) const
+  {
+    uint32_t a = (uint32_t)(angle + ROUND) % (uint32_t)ROUND;
+
+    uint32_t quadrant = a / QUARTER;
+    uint32_t rem = a - quadrant * QUARTER;
+
+    // mirror the index in quadrant 1 and 3, negate the value in quadrant 2 and 3.
+    float v = sins_[(quadrant & 1) ? (QUARTER - rem) : rem];
+    return (quadrant & 2) ? -v : v;
+  }
+
+  float sins_[QUARTER + 1];
+};
+
 }  // namespace lidar
 }  // namespace robosense
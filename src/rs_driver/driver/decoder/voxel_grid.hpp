@@ -0,0 +1,223 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/driver/decoder/member_checker.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Streaming voxel-grid filter. Points are added batch by batch while decoding, and one point per voxel 
+// is output at the end of the frame, either the centroid of the voxel's points or its first point.
+// The hash grid and the voxels are reused from frame to frame. The grid is a flat open-addressing table. Its slots
+// are stamped with the generation of the frame, so clearing it is only to start a new generation.
+//
+class VoxelGrid
+{
+public:
+
+  VoxelGrid(float leaf_size, bool centroid)
+    : inv_leaf_size_((leaf_size > 0.0f) ? (1.0f / leaf_size) : 0.0f)
+    , centroid_(centroid)
+    , gen_(1)
+    , slots_(1024)
+  {
+  }
+
+  void add(const float* xs, const float* ys, const float* zs, const uint8_t* intensities, 
+      const double* timestamps, const uint16_t* rings, size_t num)
+  {
+    for (size_t i = 0; i < num; i++)
+    {
+      if (std::isnan(xs[i]))
+      {
+        continue;
+      }
+
+      Slot& slot = find(key(xs[i], ys[i], zs[i]));
+      if (slot.gen != gen_)
+      {
+        slot.gen = gen_;
+        slot.voxel = (uint32_t)voxels_.size();
+
+        Voxel v = {xs[i], ys[i], zs[i], (float)intensities[i], 1, timestamps[i], rings[i]};
+        voxels_.push_back(v);
+
+        if (voxels_.size() * 2 > slots_.size()) // keep the load factor at most 0.5
+        {
+          grow();
+        }
+      }
+      else if (centroid_)
+      {
+        Voxel& v = voxels_[slot.voxel];
+        v.x += xs[i];
+        v.y += ys[i];
+        v.z += zs[i];
+        v.intensity += intensities[i];
+        v.count++;
+      }
+    }
+  }
+
+  size_t size() const
+  {
+    return voxels_.size();
+  }
+
+  //
+  // write the points of voxels into the cloud, and clear the grid for the next frame.
+  //
+  template <typename T_PointCloud>
+  void output(T_PointCloud& cloud, double ts_base = 0.0)
+  {
+    reservePoints(cloud, pointNum(cloud) + voxels_.size());
+
+    for (const auto& v : voxels_)
+    {
+      float inv = 1.0f / v.count;
+      addPoint(cloud, v.x * inv, v.y * inv, v.z * inv, (uint8_t)(v.intensity * inv + 0.5f), 
+          v.timestamp, v.ring, ts_base);
+    }
+
+    clear();
+  }
+
+  void clear()
+  {
+    if (++gen_ == 0) // wrapped around. stamps of old generations may come back.
+    {
+      for (auto& slot : slots_)
+      {
+        slot.gen = 0;
+      }
+      gen_ = 1;
+    }
+
+    voxels_.clear();
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  struct Voxel
+  {
+    float x; // sum of points in centroid mode
+    float y;
+    float z;
+    float intensity;
+    uint32_t count;
+    double timestamp; // of the first point
+    uint16_t ring; // of the first point
+  };
+
+  struct Slot
+  {
+    uint64_t key;
+    uint32_t voxel; // index into voxels_
+    uint32_t gen; // of the frame in which the slot is taken. free if not gen_
+  };
+
+  //
+  // the slot of the key, or the free slot where it goes. Linear probing.
+  //
+  Slot& find(uint64_t k)
+  {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash(k) & mask; ; i = (i + 1) & mask)
+    {
+      Slot& slot = slots_[i];
+      if ((slot.gen != gen_) || (slot.key == k))
+      {
+        slot.key = k;
+        return slot;
+      }
+    }
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old(slots_.size() * 2);
+    old.swap(slots_);
+
+    for (const auto& o : old)
+    {
+      if (o.gen == gen_)
+      {
+        Slot& slot = find(o.key);
+        slot.voxel = o.voxel;
+        slot.gen = gen_;
+      }
+    }
+  }
+
+  //
+  // the keys of neighbouring voxels differ only in the low bits of each index, so mix them.
+  //
+  static uint64_t hash(uint64_t k)
+  {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    return k;
+  }
+
+  //
+  // 21 bits for each of the signed indexes.
+  //
+  uint64_t key(float x, float y, float z) const
+  {
+    const uint64_t mask = (1ull << 21) - 1;
+    uint64_t ix = (uint64_t)(int64_t)std::floor(x * inv_leaf_size_) & mask;
+    uint64_t iy = (uint64_t)(int64_t)std::floor(y * inv_leaf_size_) & mask;
+    uint64_t iz = (uint64_t)(int64_t)std::floor(z * inv_leaf_size_) & mask;
+    return (ix << 42) | (iy << 21) | iz;
+  }
+
+  float inv_leaf_size_;
+  bool centroid_;
+  uint32_t gen_; // generation of the current frame
+  std::vector<Slot> slots_; // size is a power of 2
+  std::vector<Voxel> voxels_;
+};
+
+}  // namespace lidar
+}  // namespace robosense
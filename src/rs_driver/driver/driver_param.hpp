@@ -35,6 +35,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <rs_driver/common/rs_log.hpp>
 #include <string>
 #include <map>
+#include <vector>
 
 namespace robosense
 {
@@ -251,7 +252,18 @@ enum SplitFrameMode
 {
   SPLIT_BY_ANGLE = 1,
   SPLIT_BY_FIXED_BLKS,
-  SPLIT_BY_CUSTOM_BLKS
+  SPLIT_BY_CUSTOM_BLKS,
+  SPLIT_BY_TIME
+};
+
+enum DualReturnMode
+{
+  DUAL_RETURN_ALL = 0,
+  DUAL_RETURN_STRONGEST,
+  DUAL_RETURN_LAST,
+  DUAL_RETURN_FIRST,
+  DUAL_RETURN_DEDUPE,
+  DUAL_RETURN_SPLIT
 };
 
 struct RSTransformParam  ///< The Point transform parameter
@@ -277,6 +289,25 @@ struct RSTransformParam  ///< The Point transform parameter
   }
 };
 
+struct RSCropBox  ///< Box to crop points. Oriented if yaw != 0, else axis-aligned
+{
+  float x = 0.0f;          ///< center, unit, m
+  float y = 0.0f;          ///< center, unit, m
+  float z = 0.0f;          ///< center, unit, m
+  float length = 0.0f;     ///< size along x, unit, m
+  float width = 0.0f;      ///< size along y, unit, m
+  float height = 0.0f;     ///< size along z, unit, m
+  float yaw = 0.0f;        ///< rotation around z, unit, radian
+  bool include = true;     ///< true: keep points inside the box; false: discard points inside the box
+  bool transformed = false; ///< true: the box is in the transformed frame; false: in the LiDAR frame
+};
+
+struct RSRingAzimuthMask  ///< Mask of (ring, azimuth bin), to discard points blocked by the vehicle body
+{
+  uint16_t azimuth_bins = 0;    ///< Number of azimuth bins in 360 degree. 0: no mask
+  std::vector<uint8_t> masked;  ///< ring x azimuth_bins, ring-major. non-zero: discard points in the cell
+};
+
 struct RSDecoderParam  ///< LiDAR decoder parameter
 {
   bool config_from_file = false; ///< Internal use only for debugging
@@ -290,11 +321,32 @@ struct RSDecoderParam  ///< LiDAR decoder parameter
                                  ///< 1: Split frames by split_angle;
                                  ///< 2: Split frames by fixed number of blocks;
                                  ///< 3: Split frames by custom number of blocks (num_blks_split)
+                                 ///< 4: Split frames by time windows of split_period
   float split_angle = 0.0f;      ///< Split angle(degree) used to split frame, only be used when split_frame_mode=1
   uint16_t num_blks_split = 1;   ///< Number of packets in one frame, only be used when split_frame_mode=3
+  double split_period = 0.1;     ///< Period(second) of frames, only be used when split_frame_mode=4
   bool use_lidar_clock = false;  ///< true: use LiDAR clock as timestamp; false: use system clock as timestamp
   bool dense_points = false;     ///< true: discard NAN points; false: reserve NAN points
+  bool organized = false;        ///< true: place points at [ring][column] of the cloud, and fill absent ones with NAN.
+                                 ///< only be used when dense_points=false
   bool ts_first_point = false;   ///< true: time-stamp point cloud with the first point; false: with the last point;
+#ifdef ENABLE_CRC32_CHECK
+  bool check_crc32 = true;       ///< true: check CRC32 of MSOP packets, and discard wrong ones. Lidar should support it
+#else
+  bool check_crc32 = false;      ///< true: check CRC32 of MSOP packets, and discard wrong ones. Lidar should support it
+#endif
+  float voxel_size = 0.0f;       ///< Leaf size(m) of voxel-grid downsampling. 0: no downsampling
+  bool voxel_centroid = true;    ///< true: output the centroid of points in a voxel; false: the first point
+  uint16_t sector_pkts = 0;      ///< Output a sector of the frame every N packets. 0: disabled
+  float sector_angle = 0.0f;     ///< Output a sector of the frame every X degrees of azimuth. 0: disabled
+  DualReturnMode dual_return_mode = DualReturnMode::DUAL_RETURN_ALL;
+                                 ///< 0: Keep both returns of a firing in dual return mode;
+                                 ///< 1: Keep the strongest one; 2: Keep the last (farthest) one;
+                                 ///< 3: Keep the first (nearest) one; 4: Keep one if their distances are the same;
+                                 ///< 5: Output the second one in a separate point cloud
+  float dual_return_tolerance = 0.02f; ///< Max distance difference(m) of the same returns, only for dual_return_mode=4
+  std::vector<RSCropBox> crop_boxes; ///< Boxes to keep or discard points
+  RSRingAzimuthMask ring_azimuth_mask; ///< Mask to discard points blocked by the vehicle body
   RSTransformParam transform_param; ///< Used to transform points
 
   void print() const
@@ -308,11 +360,22 @@ struct RSDecoderParam  ///< LiDAR decoder parameter
     RS_INFOL << "end_angle: " << end_angle << RS_REND;
     RS_INFOL << "use_lidar_clock: " << use_lidar_clock << RS_REND;
     RS_INFOL << "dense_points: " << dense_points << RS_REND;
+    RS_INFOL << "organized: " << organized << RS_REND;
+    RS_INFOL << "check_crc32: " << check_crc32 << RS_REND;
+    RS_INFOL << "voxel_size: " << voxel_size << RS_REND;
+    RS_INFOL << "voxel_centroid: " << voxel_centroid << RS_REND;
+    RS_INFOL << "sector_pkts: " << sector_pkts << RS_REND;
+    RS_INFOL << "sector_angle: " << sector_angle << RS_REND;
+    RS_INFOL << "dual_return_mode: " << dual_return_mode << RS_REND;
+    RS_INFOL << "dual_return_tolerance: " << dual_return_tolerance << RS_REND;
+    RS_INFOL << "crop_boxes: " << crop_boxes.size() << RS_REND;
+    RS_INFOL << "ring_azimuth_mask.azimuth_bins: " << ring_azimuth_mask.azimuth_bins << RS_REND;
     RS_INFOL << "config_from_file: " << config_from_file << RS_REND;
     RS_INFOL << "angle_path: " << angle_path << RS_REND;
     RS_INFOL << "split_frame_mode: " << split_frame_mode << RS_REND;
     RS_INFOL << "split_angle: " << split_angle << RS_REND;
     RS_INFOL << "num_blks_split: " << num_blks_split << RS_REND;
+    RS_INFOL << "split_period: " << split_period << RS_REND;
     RS_INFO << "------------------------------------------------------" << RS_REND;
     transform_param.print();
   }
@@ -62,6 +62,7 @@ public:
   virtual bool init() = 0;
   virtual bool start() = 0;
   virtual void stop();
+  virtual bool readPacket(); // read a packet on the caller's thread, instead of start(). false at the end of input
   virtual ~Input()
   {
   }
@@ -106,6 +107,11 @@ inline void Input::stop()
   }
 }
 
+inline bool Input::readPacket()
+{
+  return false;
+}
+
 inline void Input::pushPacket(std::shared_ptr<Buffer> pkt, bool stuffed)
 {
   cb_put_pkt_(pkt, stuffed);
@@ -77,6 +77,7 @@ public:
 
   virtual bool init();
   virtual bool start();
+  virtual bool readPacket();
   virtual ~InputPcap();
 
 private:
@@ -148,14 +149,37 @@ inline InputPcap::~InputPcap()
   }
 }
 
-inline void InputPcap::recvPacket()
+inline bool InputPcap::readPacket()
 {
-  while (!to_exit_recv_)
+  while (pcap_ != NULL)
   {
     struct pcap_pkthdr* header;
     const u_char* pkt_data;
     int ret = pcap_next_ex(pcap_, &header, &pkt_data);
     if (ret < 0)  // reach file end.
+    {
+      return false;
+    }
+
+    if ((pcap_offline_filter(&msop_filter_, header, pkt_data) != 0) ||
+        (difop_filter_valid_ && (pcap_offline_filter(&difop_filter_, header, pkt_data) != 0)))
+    {
+      std::shared_ptr<Buffer> pkt = cb_get_pkt_(ETH_LEN);
+      memcpy(pkt->data(), pkt_data + pcap_offset_, header->len - pcap_offset_ - pcap_tail_);
+      pkt->setData(0, header->len - pcap_offset_ - pcap_tail_);
+      pushPacket(pkt);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+inline void InputPcap::recvPacket()
+{
+  while (!to_exit_recv_)
+  {
+    if (!readPacket())  // reach file end.
     {
       pcap_close(pcap_);
       pcap_ = NULL;
@@ -175,25 +199,6 @@ inline void InputPcap::recvPacket()
       }
     }
 
-    if (pcap_offline_filter(&msop_filter_, header, pkt_data) != 0)
-    {
-      std::shared_ptr<Buffer> pkt = cb_get_pkt_(ETH_LEN);
-      memcpy(pkt->data(), pkt_data + pcap_offset_, header->len - pcap_offset_ - pcap_tail_);
-      pkt->setData(0, header->len - pcap_offset_ - pcap_tail_);
-      pushPacket(pkt);
-    }
-    else if (difop_filter_valid_ && (pcap_offline_filter(&difop_filter_, header, pkt_data) != 0))
-    {
-      std::shared_ptr<Buffer> pkt = cb_get_pkt_(ETH_LEN);
-      memcpy(pkt->data(), pkt_data + pcap_offset_, header->len - pcap_offset_ - pcap_tail_);
-      pkt->setData(0, header->len - pcap_offset_ - pcap_tail_);
-      pushPacket(pkt);
-    }
-    else
-    {
-      continue;
-    }
-
     std::this_thread::sleep_for(std::chrono::microseconds(msec_to_delay_));
   }
 }
@@ -75,6 +75,7 @@ public:
 
   virtual bool init();
   virtual bool start();
+  virtual bool readPacket();
   virtual ~InputPcapJumbo();
 
 private:
@@ -141,14 +142,43 @@ inline InputPcapJumbo::~InputPcapJumbo()
   }
 }
 
-inline void InputPcapJumbo::recvPacket()
+inline bool InputPcapJumbo::readPacket()
 {
-  while (!to_exit_recv_)
+  while (pcap_ != NULL)
   {
     struct pcap_pkthdr* header;
     const uint8_t* pkt_data;
     int ret = pcap_next_ex(pcap_, &header, &pkt_data);
     if (ret < 0)  // reach file end.
+    {
+      return false;
+    }
+
+    if (pcap_offline_filter(&msop_filter_, header, pkt_data) != 0)
+    {
+      uint16_t udp_port = 0;
+      const uint8_t* udp_data = NULL;
+      size_t udp_data_len = 0;
+      bool new_pkt = jumbo_.new_fragment(pkt_data, header->len, &udp_port, &udp_data, &udp_data_len);
+      if (new_pkt && ((udp_port == input_param_.msop_port) || (udp_port == input_param_.difop_port)))
+      {
+        std::shared_ptr<Buffer> pkt = cb_get_pkt_(IP_LEN);
+        memcpy(pkt->data(), udp_data, udp_data_len);
+        pkt->setData(0, udp_data_len);
+        pushPacket(pkt);
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+inline void InputPcapJumbo::recvPacket()
+{
+  while (!to_exit_recv_)
+  {
+    if (!readPacket())  // reach file end.
     {
       pcap_close(pcap_);
       pcap_ = NULL;
@@ -168,28 +198,6 @@ inline void InputPcapJumbo::recvPacket()
       }
     }
 
-    if (pcap_offline_filter(&msop_filter_, header, pkt_data) != 0)
-    {
-      uint16_t udp_port = 0;
-      const uint8_t* udp_data = NULL;
-      size_t udp_data_len = 0;
-      bool new_pkt = jumbo_.new_fragment(pkt_data, header->len, &udp_port, &udp_data, &udp_data_len);
-      if (new_pkt)
-      {
-        if ((udp_port == input_param_.msop_port) || (udp_port == input_param_.difop_port))
-        {
-          std::shared_ptr<Buffer> pkt = cb_get_pkt_(IP_LEN);
-          memcpy(pkt->data(), udp_data, udp_data_len);
-          pkt->setData(0, udp_data_len);
-          pushPacket(pkt);
-        }
-      }
-    }
-    else
-    {
-      continue;
-    }
-
     std::this_thread::sleep_for(std::chrono::microseconds(msec_to_delay_));
   }
 }
@@ -38,6 +38,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <rs_driver/macro/version.hpp>
 #include <rs_driver/utility/sync_queue.hpp>
 #include <rs_driver/utility/buffer.hpp>
+#include <rs_driver/utility/cloud_pool.hpp>
 #include <rs_driver/driver/input/input_factory.hpp>
 #include <rs_driver/driver/decoder/decoder_factory.hpp>
 
@@ -69,8 +70,19 @@ public:
   void regPointCloudCallback(
       const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
       const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud);
+  void regPointCloudPool(std::shared_ptr<CloudPool<T_PointCloud>> pool);
   void regPacketCallback(const std::function<void(const Packet&)>& cb_put_pkt);
   void regExceptionCallback(const std::function<void(const Error&)>& cb_excep);
+  void regPoseCallback(const std::function<bool(double, RSPose&)>& cb_get_pose);
+  void regDownsampledPointCloudCallback(
+      const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud);
+  void regSecondEchoPointCloudCallback(
+      const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud);
+  void regSectorCallback(
+      const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+      const std::function<void(std::shared_ptr<T_PointCloud>, const SectorInfo&)>& cb_put_sector);
  
   bool init(const RSDriverParam& param);
   bool start();
@@ -80,8 +92,12 @@ public:
   bool getTemperature(float& temp);
   bool getDeviceInfo(DeviceInfo& info);
   bool getDeviceStatus(DeviceStatus& status);
+  bool getMaxPointsPerFrame(size_t& num);
+  bool getMaxPointsPerFrameAnyEcho(size_t& num);
 
+#ifndef UNIT_TEST
 private:
+#endif
 
   void runPacketCallBack(uint8_t* data, size_t data_size, double timestamp, uint8_t is_difop, uint8_t is_frame_begin);
   void runExceptionCallback(const Error& error);
@@ -91,15 +107,26 @@ private:
 
   void processPacket();
 
-  std::shared_ptr<T_PointCloud> getPointCloud();
+  std::shared_ptr<T_PointCloud> getCloud(
+      const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud, size_t reserve);
+  size_t frameReserve();
+  bool initClouds(const RSDecoderParam& param);
   void splitFrame(uint16_t height, double ts);
-  void setPointCloudHeader(std::shared_ptr<T_PointCloud> msg, uint16_t height, double chan_ts);
+  void putSector(size_t from, size_t to, double ts, const SectorInfo& info);
+  void setPointCloudHeader(std::shared_ptr<T_PointCloud> msg, uint16_t height, double chan_ts, uint32_t seq);
 
   RSDriverParam driver_param_;
   std::function<std::shared_ptr<T_PointCloud>(void)> cb_get_cloud_;
   std::function<void(std::shared_ptr<T_PointCloud>)> cb_put_cloud_;
   std::function<void(const Packet&)> cb_put_pkt_;
   std::function<void(const Error&)> cb_excep_;
+  std::function<bool(double, RSPose&)> cb_get_pose_;
+  std::function<std::shared_ptr<T_PointCloud>(void)> cb_get_ds_cloud_;
+  std::function<void(std::shared_ptr<T_PointCloud>)> cb_put_ds_cloud_;
+  std::function<std::shared_ptr<T_PointCloud>(void)> cb_get_echo_cloud_;
+  std::function<void(std::shared_ptr<T_PointCloud>)> cb_put_echo_cloud_;
+  std::function<std::shared_ptr<T_PointCloud>(void)> cb_get_sector_cloud_;
+  std::function<void(std::shared_ptr<T_PointCloud>, const SectorInfo&)> cb_put_sector_;
   std::function<void(const uint8_t*, size_t)> cb_feed_pkt_;
 
   std::shared_ptr<Input> input_ptr_;
@@ -110,13 +137,15 @@ private:
   uint32_t pkt_seq_;
   uint32_t point_cloud_seq_;
   bool to_exit_handle_;
+  bool ds_instead_; // output the downsampled point cloud instead of the full one
+  bool clouds_ready_; // clouds of the decoder are gotten from the caller
   bool init_flag_;
   bool start_flag_;
 };
 
 template <typename T_PointCloud>
 inline LidarDriverImpl<T_PointCloud>::LidarDriverImpl()
-  : pkt_seq_(0), point_cloud_seq_(0), init_flag_(false), start_flag_(false)
+  : pkt_seq_(0), point_cloud_seq_(0), ds_instead_(false), clouds_ready_(false), init_flag_(false), start_flag_(false)
 {
 }
 
@@ -126,20 +155,59 @@ inline LidarDriverImpl<T_PointCloud>::~LidarDriverImpl()
   stop();
 }
 
+//
+// get a cloud from the caller. If none is available, the frame is dropped, instead of waiting here.
+//
 template <typename T_PointCloud>
-std::shared_ptr<T_PointCloud> LidarDriverImpl<T_PointCloud>::getPointCloud()
+std::shared_ptr<T_PointCloud> LidarDriverImpl<T_PointCloud>::getCloud(
+    const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud, size_t reserve)
 {
-  while (1)
+  std::shared_ptr<T_PointCloud> cloud = cb_get_cloud();
+  if (!cloud)
   {
-    std::shared_ptr<T_PointCloud> cloud = cb_get_cloud_();
-    if (cloud)
-    {
-      cloud->points.resize(0);
-      return cloud;
-    }
-
     LIMIT_CALL(runExceptionCallback(Error(ERRCODE_POINTCLOUDNULL)), 1);
+    return nullptr;
   }
+
+  clearPoints(*cloud);
+
+  // reserve for a whole frame, so that the cloud will not be reallocated while it grows.
+  reservePoints(*cloud, reserve);
+  return cloud;
+}
+
+template <typename T_PointCloud>
+void LidarDriverImpl<T_PointCloud>::regPointCloudPool(std::shared_ptr<CloudPool<T_PointCloud>> pool)
+{
+  cb_get_cloud_ = [pool]() { return pool->get(); };
+  cb_put_cloud_ = [pool](std::shared_ptr<T_PointCloud> cloud) { pool->put(cloud); };
+}
+
+template <typename T_PointCloud>
+void LidarDriverImpl<T_PointCloud>::regSectorCallback( 
+    const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+    const std::function<void(std::shared_ptr<T_PointCloud>, const SectorInfo&)>& cb_put_sector) 
+{
+  cb_get_sector_cloud_ = cb_get_cloud;
+  cb_put_sector_ = cb_put_sector;
+}
+
+template <typename T_PointCloud>
+void LidarDriverImpl<T_PointCloud>::regSecondEchoPointCloudCallback( 
+    const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+    const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud) 
+{
+  cb_get_echo_cloud_ = cb_get_cloud;
+  cb_put_echo_cloud_ = cb_put_cloud;
+}
+
+template <typename T_PointCloud>
+void LidarDriverImpl<T_PointCloud>::regDownsampledPointCloudCallback( 
+    const std::function<std::shared_ptr<T_PointCloud>(void)>& cb_get_cloud,
+    const std::function<void(std::shared_ptr<T_PointCloud>)>& cb_put_cloud) 
+{
+  cb_get_ds_cloud_ = cb_get_cloud;
+  cb_put_ds_cloud_ = cb_put_cloud;
 }
 
 template <typename T_PointCloud>
@@ -158,6 +226,13 @@ inline void LidarDriverImpl<T_PointCloud>::regPacketCallback(
   cb_put_pkt_ = cb_put_pkt;
 }
 
+template <typename T_PointCloud>
+inline void LidarDriverImpl<T_PointCloud>::regPoseCallback(
+    const std::function<bool(double, RSPose&)>& cb_get_pose)
+{
+  cb_get_pose_ = cb_get_pose;
+}
+
 template <typename T_PointCloud>
 inline void LidarDriverImpl<T_PointCloud>::regExceptionCallback(
     const std::function<void(const Error&)>& cb_excep)
@@ -165,6 +240,50 @@ inline void LidarDriverImpl<T_PointCloud>::regExceptionCallback(
   cb_excep_ = cb_excep;
 }
 
+template <typename T_PointCloud>
+inline bool LidarDriverImpl<T_PointCloud>::initClouds(const RSDecoderParam& param)
+{
+  decoder_ptr_->point_cloud_ = getCloud(cb_get_cloud_, frameReserve());
+  if (!decoder_ptr_->point_cloud_)
+  {
+    return false;
+  }
+
+  if ((param.voxel_size > 0.0f) && cb_put_ds_cloud_)
+  {
+    decoder_ptr_->voxel_cloud_ = getCloud(cb_get_ds_cloud_, 0);
+    if (!decoder_ptr_->voxel_cloud_)
+    {
+      return false;
+    }
+  }
+
+  if ((param.dual_return_mode == DUAL_RETURN_SPLIT) && (param.voxel_size <= 0.0f))
+  {
+    if (!cb_put_echo_cloud_)
+    {
+      RS_WARNING << "dual_return_mode is DUAL_RETURN_SPLIT, but no second echo callback is registered."
+                 << " second returns are discarded." << RS_REND;
+      return true;
+    }
+
+    decoder_ptr_->echo_cloud_ = getCloud(cb_get_echo_cloud_, decoder_ptr_->getMaxPointsPerFrame());
+    if (!decoder_ptr_->echo_cloud_)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <typename T_PointCloud>
+inline size_t LidarDriverImpl<T_PointCloud>::frameReserve()
+{
+  // the full point cloud is not built, if the downsampled one is output instead.
+  return ds_instead_ ? 0 : decoder_ptr_->getMaxPointsPerFrame();
+}
+
 template <typename T_PointCloud>
 inline bool LidarDriverImpl<T_PointCloud>::init(const RSDriverParam& param)
 {
@@ -182,10 +301,21 @@ inline bool LidarDriverImpl<T_PointCloud>::init(const RSDriverParam& param)
   decoder_ptr_->enableWritePktTs((cb_put_pkt_ == nullptr) ? false : true);
 
   // point cloud related
-  decoder_ptr_->point_cloud_ = getPointCloud();
+  ds_instead_ = (param.decoder_param.voxel_size > 0.0f) && !cb_put_ds_cloud_ && 
+    !RS_HAS_MEMBER(T_PointCloud, distances);
+
+  // if the caller has no cloud yet, get it again with the first MSOP packet.
+  clouds_ready_ = initClouds(param.decoder_param);
+
   decoder_ptr_->regCallback( 
       std::bind(&LidarDriverImpl<T_PointCloud>::runExceptionCallback, this, std::placeholders::_1),
       std::bind(&LidarDriverImpl<T_PointCloud>::splitFrame, this, std::placeholders::_1, std::placeholders::_2));
+  decoder_ptr_->regPoseCallback(cb_get_pose_);
+  if (cb_put_sector_)
+  {
+    decoder_ptr_->regSectorCallback(std::bind(&LidarDriverImpl<T_PointCloud>::putSector, this, 
+          std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+  }
 
   double packet_duration = decoder_ptr_->getPacketDuration();
   bool is_jumbo = isJumbo(param.lidar_type);
@@ -253,7 +383,7 @@ inline void LidarDriverImpl<T_PointCloud>::stop()
   // clear all points before next session
   if (decoder_ptr_->point_cloud_)
   {
-    decoder_ptr_->point_cloud_->points.clear();
+    clearPoints(*decoder_ptr_->point_cloud_);
   }
 
   start_flag_ = false;
@@ -299,6 +429,30 @@ inline bool LidarDriverImpl<T_PointCloud>::getDeviceStatus(DeviceStatus& status)
   return decoder_ptr_->getDeviceStatus(status);
 }
 
+template <typename T_PointCloud>
+inline bool LidarDriverImpl<T_PointCloud>::getMaxPointsPerFrame(size_t& num)
+{
+  if (decoder_ptr_ == nullptr)
+  {
+    return false;
+  }
+
+  num = decoder_ptr_->getMaxPointsPerFrame();
+  return true;
+}
+
+template <typename T_PointCloud>
+inline bool LidarDriverImpl<T_PointCloud>::getMaxPointsPerFrameAnyEcho(size_t& num)
+{
+  if (decoder_ptr_ == nullptr)
+  {
+    return false;
+  }
+
+  num = decoder_ptr_->getMaxPointsPerFrameAnyEcho();
+  return true;
+}
+
 template <typename T_PointCloud>
 inline void LidarDriverImpl<T_PointCloud>::runPacketCallBack(uint8_t* data, size_t data_size,
     double timestamp, uint8_t is_difop, uint8_t is_frame_begin)
@@ -375,6 +529,12 @@ inline void LidarDriverImpl<T_PointCloud>::processPacket()
     uint8_t* id = pkt->data();
     if (memcmp(id, msop_id, sizeof(msop_id)) == 0)
     {
+      if (!clouds_ready_ && !(clouds_ready_ = initClouds(driver_param_.decoder_param)))
+      {
+        free_pkt_queue_.push(pkt);
+        continue;
+      }
+
       bool pkt_to_split = decoder_ptr_->processMsopPkt(pkt->data(), pkt->dataSize());
       runPacketCallBack(pkt->data(), pkt->dataSize(), decoder_ptr_->prevPktTs(), false, pkt_to_split); // msop packet
     }
@@ -391,35 +551,114 @@ inline void LidarDriverImpl<T_PointCloud>::processPacket()
 template <typename T_PointCloud>
 void LidarDriverImpl<T_PointCloud>::splitFrame(uint16_t height, double ts)
 {
+  // the cloud is the consumer's once it is put, so don't read it any more.
+  uint32_t seq = point_cloud_seq_;
+
   std::shared_ptr<T_PointCloud> cloud = decoder_ptr_->point_cloud_;
-  if (cloud->points.size() > 0)
+  if (pointNum(*cloud) > 0)
   {
-    setPointCloudHeader(cloud, height, ts);
-    cb_put_cloud_(cloud);
-    decoder_ptr_->point_cloud_ = getPointCloud();
+    setPointCloudHeader(cloud, height, ts, point_cloud_seq_++);
+
+    // if no cloud is available for the next frame, drop this one and reuse its cloud.
+    std::shared_ptr<T_PointCloud> next = getCloud(cb_get_cloud_, frameReserve());
+    if (next)
+    {
+      cb_put_cloud_(cloud);
+      decoder_ptr_->point_cloud_ = next;
+    }
+    else
+    {
+      clearPoints(*cloud);
+    }
   }
   else
   {
     runExceptionCallback(Error(ERRCODE_ZEROPOINTS));
   }
+
+  // the downsampled point cloud, output alongside the full one
+  std::shared_ptr<T_PointCloud> ds_cloud = decoder_ptr_->voxel_cloud_;
+  if (ds_cloud && (pointNum(*ds_cloud) > 0))
+  {
+    ds_cloud->seq = seq;
+    ds_cloud->timestamp = ts;
+    ds_cloud->is_dense = true;
+    ds_cloud->height = 1;
+    ds_cloud->width = (uint32_t)pointNum(*ds_cloud);
+    ds_cloud->frame_id = driver_param_.frame_id;
+
+    std::shared_ptr<T_PointCloud> next = getCloud(cb_get_ds_cloud_, 0);
+    if (next)
+    {
+      cb_put_ds_cloud_(ds_cloud);
+      decoder_ptr_->voxel_cloud_ = next;
+    }
+    else
+    {
+      clearPoints(*ds_cloud);
+    }
+  }
+
+  // the second returns, aligned with the point cloud
+  std::shared_ptr<T_PointCloud> echo_cloud = decoder_ptr_->echo_cloud_;
+  if (echo_cloud && (pointNum(*echo_cloud) > 0))
+  {
+    setPointCloudHeader(echo_cloud, height, ts, seq);
+
+    std::shared_ptr<T_PointCloud> next = getCloud(cb_get_echo_cloud_, decoder_ptr_->getMaxPointsPerFrame());
+    if (next)
+    {
+      cb_put_echo_cloud_(echo_cloud);
+      decoder_ptr_->echo_cloud_ = next;
+    }
+    else
+    {
+      clearPoints(*echo_cloud);
+    }
+  }
+}
+
+template <typename T_PointCloud>
+void LidarDriverImpl<T_PointCloud>::putSector(size_t from, size_t to, double ts, const SectorInfo& info)
+{
+  std::shared_ptr<T_PointCloud> sector = getCloud(cb_get_sector_cloud_, to - from);
+  if (!sector)
+  {
+    return;
+  }
+
+  appendPoints(*sector, *decoder_ptr_->point_cloud_, from, to);
+
+  // the seq which the frame will be given
+  SectorInfo sector_info = info;
+  sector_info.seq = point_cloud_seq_;
+
+  sector->seq = sector_info.seq;
+  sector->timestamp = ts;
+  sector->is_dense = driver_param_.decoder_param.dense_points;
+  sector->height = 1;
+  sector->width = (uint32_t)pointNum(*sector);
+  sector->frame_id = driver_param_.frame_id;
+  cb_put_sector_(sector, sector_info);
 }
 
 template <typename T_PointCloud>
 void LidarDriverImpl<T_PointCloud>::setPointCloudHeader(std::shared_ptr<T_PointCloud> msg, 
-    uint16_t height, double ts)
+    uint16_t height, double ts, uint32_t seq)
 {
-  msg->seq = point_cloud_seq_++;
+  msg->seq = seq;
   msg->timestamp = ts;
-  msg->is_dense = driver_param_.decoder_param.dense_points;
+  msg->is_dense = (driver_param_.decoder_param.dense_points || ds_instead_) && 
+    !RS_HAS_MEMBER(T_PointCloud, col_timestamps);
   if (msg->is_dense)
   {
     msg->height = 1;
-    msg->width = (uint32_t)msg->points.size();
+    msg->width = (uint32_t)pointNum(*msg);
   }
   else
   {
     msg->height = height;
-    msg->width = (uint32_t)msg->points.size() / msg->height;
+    msg->width = (uint32_t)pointNum(*msg) / msg->height;
   }
 
   msg->frame_id = driver_param_.frame_id;
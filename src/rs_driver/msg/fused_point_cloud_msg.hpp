@@ -0,0 +1,212 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+//
+// Array of points on a slot of a shared buffer. It offers the part of std::vector's 
+// interface used by the decoder, and never allocates. Points beyond its capacity 
+// are dropped, and counted.
+//
+template <typename T_Point>
+class PointSlice
+{
+public:
+
+  PointSlice()
+    : data_(nullptr), capacity_(0), size_(0), dropped_(0)
+  {
+  }
+
+  void bind(T_Point* data, size_t capacity)
+  {
+    data_ = data;
+    capacity_ = capacity;
+    size_ = 0;
+    dropped_ = 0;
+  }
+
+  void push_back(const T_Point& point)
+  {
+    if (size_ < capacity_)
+    {
+      data_[size_++] = point;
+    }
+    else
+    {
+      dropped_++;
+    }
+  }
+
+  void emplace_back(const T_Point& point)
+  {
+    push_back(point);
+  }
+
+  template <typename T_Iterator>
+  void insert(T_Point*, T_Iterator first, T_Iterator last)
+  {
+    for (; first != last; ++first)
+    {
+      push_back(*first);
+    }
+  }
+
+  T_Point& operator[](size_t i)
+  {
+    return data_[i];
+  }
+
+  const T_Point& operator[](size_t i) const
+  {
+    return data_[i];
+  }
+
+  T_Point* begin()
+  {
+    return data_;
+  }
+
+  T_Point* end()
+  {
+    return data_ + size_;
+  }
+
+  const T_Point* begin() const
+  {
+    return data_;
+  }
+
+  const T_Point* end() const
+  {
+    return data_ + size_;
+  }
+
+  T_Point* data()
+  {
+    return data_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  size_t capacity() const
+  {
+    return capacity_;
+  }
+
+  size_t dropped() const
+  {
+    return dropped_;
+  }
+
+  void clear()
+  {
+    size_ = 0;
+  }
+
+  void reserve(size_t)
+  {
+  }
+
+  void resize(size_t num)
+  {
+    size_ = (num < capacity_) ? num : capacity_;
+  }
+
+private:
+
+  T_Point* data_;
+  size_t capacity_;
+  size_t size_;
+  size_t dropped_;
+};
+
+//
+// Point cloud of a lidar, written directly into its slot of a fused point cloud.
+//
+template <typename T_Point>
+class SlicePointCloudT
+{
+public:
+  typedef T_Point PointT;
+  typedef PointSlice<PointT> VectorT;
+
+  uint32_t height = 0;    ///< Height of point cloud
+  uint32_t width = 0;     ///< Width of point cloud
+  bool is_dense = false;  ///< If is_dense is true, the point cloud does not contain NAN points,
+  double timestamp = 0.0;
+  uint32_t seq = 0;           ///< Sequence number of message
+  std::string frame_id = "";  ///< Point cloud frame id
+
+  VectorT points;
+};
+
+//
+// Where the points of a lidar are in the fused point cloud, and its own header.
+//
+struct LidarSlice
+{
+  size_t offset = 0;          ///< Index of the first point of the lidar in points
+  size_t size = 0;            ///< Number of points of the lidar. The rest of its slot is NAN points.
+  bool received = false;      ///< false if no frame of the lidar covers the time window
+  double timestamp = 0.0;     ///< Timestamp of the lidar's frame
+  uint32_t seq = 0;           ///< Sequence number of the lidar's frame
+  std::string frame_id = "";  ///< Frame id of the lidar
+};
+
+//
+// Point cloud of multiple lidars in the same time window. Each lidar has its own slot in points.
+//
+template <typename T_Point>
+class FusedPointCloudT
+{
+public:
+  typedef T_Point PointT;
+  typedef std::vector<PointT> VectorT;
+
+  uint32_t height = 0;    ///< Height of point cloud
+  uint32_t width = 0;     ///< Width of point cloud
+  bool is_dense = false;  ///< If is_dense is true, the point cloud does not contain NAN points,
+  double timestamp = 0.0;     ///< Start of the time window
+  uint32_t seq = 0;           ///< Sequence number of message
+  std::string frame_id = "";  ///< Point cloud frame id
+
+  VectorT points;
+  std::vector<LidarSlice> sources; ///< One per lidar, in the order of MultiLidarDriver::init()
+};
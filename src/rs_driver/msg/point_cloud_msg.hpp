@@ -53,6 +53,59 @@ struct PointXYZIRT
   double timestamp;
 };
 
+//
+// Points with timestamp offsets to the timestamp of point cloud, which is the timestamp of 
+// the first point of the frame. ts_offset is in second, and ts_offset_ns is in nanosecond.
+//
+struct PointXYZIRTOffset
+{
+  float x;
+  float y;
+  float z;
+  uint8_t intensity;
+  uint16_t ring;
+  float ts_offset;
+};
+
+struct PointXYZIRTOffsetNs
+{
+  float x;
+  float y;
+  float z;
+  uint8_t intensity;
+  uint16_t ring;
+  uint32_t ts_offset_ns;
+};
+
+//
+// Compact points with quantized coordinates. x/y/z are integers in unit of xyz_res (in meter),
+// i.e. the coordinate in meter is x * xyz_res. The minimum of the integer is reserved: NAN points,
+// and points out of range, have it in all of x/y/z. If dense_points is true, they are dropped instead.
+//
+// PointXYZIRQ16 is 8 bytes. Its coordinates are in range of about +/-163 m.
+//
+struct PointXYZIRQ16
+{
+  constexpr static float xyz_res = 0.005f;
+
+  int16_t x;
+  int16_t y;
+  int16_t z;
+  uint8_t intensity;
+  uint8_t ring;
+};
+
+struct PointXYZIRQ32
+{
+  constexpr static float xyz_res = 0.001f;
+
+  int32_t x;
+  int32_t y;
+  int32_t z;
+  uint8_t intensity;
+  uint8_t ring;
+};
+
 template <typename T_Point>
 class PointCloudT
 {
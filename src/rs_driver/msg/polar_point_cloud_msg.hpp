@@ -0,0 +1,94 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+//
+// Point cloud of polar measurements, without xyz. The decoder saves only the raw fields of points, 
+// and a consumer calculates xyz of the points it keeps, with PolarCloudView. 
+//
+// Angles are in 0.01 degree, and in the convention of mechanical lidars, i.e. 
+//   x =  distance * cos(elevation) * cos(azimuth) + rx * cos(azimuth)
+//   y = -distance * cos(elevation) * sin(azimuth) - rx * sin(azimuth)
+//   z =  distance * sin(elevation) + rz
+//
+class PolarPointCloud
+{
+public:
+
+  uint32_t height = 0;    ///< Height of point cloud
+  uint32_t width = 0;     ///< Width of point cloud
+  bool is_dense = false;  ///< If is_dense is true, the point cloud does not contain invalid points
+  double timestamp = 0.0;
+  uint32_t seq = 0;           ///< Sequence number of message
+  std::string frame_id = "";  ///< Point cloud frame id
+
+  double ts_base = 0.0;  ///< Timestamp of the first point. Timestamps of points are offsets to it
+  float rx = 0.0f;       ///< Offset of the optical center, in meter
+  float rz = 0.0f;       ///< Offset of the optical center, in meter
+
+  std::vector<float> distances;     ///< In meter. 0 means an invalid point
+  std::vector<int32_t> azimuths;    ///< Horizontal angle, in 0.01 degree. INT32_MIN if the lidar gives no angles
+  std::vector<int32_t> elevations;  ///< Vertical angle, in 0.01 degree. INT32_MIN if the lidar gives no angles
+  std::vector<uint16_t> rings;
+  std::vector<uint8_t> intensities;
+  std::vector<float> ts_offsets;    ///< Timestamp offset to ts_base, in second
+
+  size_t size() const
+  {
+    return distances.size();
+  }
+
+  void clear()
+  {
+    distances.clear();
+    azimuths.clear();
+    elevations.clear();
+    rings.clear();
+    intensities.clear();
+    ts_offsets.clear();
+  }
+
+  void reserve(size_t num)
+  {
+    distances.reserve(num);
+    azimuths.reserve(num);
+    elevations.reserve(num);
+    rings.reserve(num);
+    intensities.reserve(num);
+    ts_offsets.reserve(num);
+  }
+};
@@ -0,0 +1,88 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+//
+// Native range image of a frame, without xyz. It is a grid of height (lasers) x width (columns),
+// saved row by row. 
+//
+// The distance of a cell is saved as a multiple of distance_res, and 0 means no return. 
+// Each column has its own timestamp, and each row has its own vertical angle. 
+// The decoder skips calculating xyz for this kind of cloud.
+//
+class RangeImage
+{
+public:
+
+  uint32_t height = 0;    ///< Height of range image (rows)
+  uint32_t width = 0;     ///< Width of range image (columns)
+  bool is_dense = false;  ///< Always false for range image
+  double timestamp = 0.0;
+  uint32_t seq = 0;           ///< Sequence number of message
+  std::string frame_id = "";  ///< Point cloud frame id
+
+  float distance_res = 0.0f;  ///< Resolution of distances, in meter
+
+  std::vector<uint16_t> distances;   ///< height x width, in distance_res. 0 means no return
+  std::vector<uint8_t> intensities;  ///< height x width
+  std::vector<double> col_timestamps;  ///< width, timestamp of each column
+  std::vector<float> row_vert_angles;  ///< height, vertical angle of each row, in degree. NAN if unknown
+
+  size_t size() const
+  {
+    return distances.size();
+  }
+
+  void clear()
+  {
+    distances.clear();
+    intensities.clear();
+    col_timestamps.clear();
+    row_vert_angles.clear();
+  }
+
+  void reserve(size_t num)
+  {
+    distances.reserve(num);
+    intensities.reserve(num);
+  }
+
+  float rangeAt(uint32_t row, uint32_t col) const
+  {
+    return distances[(size_t)row * width + col] * distance_res;
+  }
+};
@@ -0,0 +1,99 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+//
+// Point cloud in layout of structure-of-arrays. Each attribute of points is saved
+// in its own contiguous array. 
+// 
+// A user-defined cloud of this layout may omit any of the arrays, and the decoder 
+// will skip it. Such a cloud should also provide size(), clear(), reserve() and resize().
+//
+class PointCloudSoA
+{
+public:
+
+  uint32_t height = 0;    ///< Height of point cloud
+  uint32_t width = 0;     ///< Width of point cloud
+  bool is_dense = false;  ///< If is_dense is true, the point cloud does not contain NAN points,
+  double timestamp = 0.0;
+  uint32_t seq = 0;           ///< Sequence number of message
+  std::string frame_id = "";  ///< Point cloud frame id
+
+  std::vector<float> xs;
+  std::vector<float> ys;
+  std::vector<float> zs;
+  std::vector<uint8_t> intensities;
+  std::vector<uint16_t> rings;
+  std::vector<double> timestamps;
+
+  size_t size() const
+  {
+    return xs.size();
+  }
+
+  void clear()
+  {
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    intensities.clear();
+    rings.clear();
+    timestamps.clear();
+  }
+
+  void reserve(size_t num)
+  {
+    xs.reserve(num);
+    ys.reserve(num);
+    zs.reserve(num);
+    intensities.reserve(num);
+    rings.reserve(num);
+    timestamps.reserve(num);
+  }
+
+  void resize(size_t num)
+  {
+    xs.resize(num);
+    ys.resize(num);
+    zs.resize(num);
+    intensities.resize(num);
+    rings.resize(num);
+    timestamps.resize(num);
+  }
+};
+
@@ -0,0 +1,195 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+//
+// Array on a buffer provided by the caller. It offers the part of std::vector's 
+// interface used by the decoder, and never allocates. Values beyond its capacity 
+// are dropped and counted.
+//
+template <typename T>
+class SpanArray
+{
+public:
+
+  SpanArray()
+    : data_(nullptr), capacity_(0), size_(0), dropped_(0)
+  {
+  }
+
+  void bind(T* data, size_t capacity)
+  {
+    data_ = data;
+    capacity_ = (data != nullptr) ? capacity : 0;
+    size_ = 0;
+    dropped_ = 0;
+  }
+
+  void push_back(const T& value)
+  {
+    if (size_ < capacity_)
+    {
+      data_[size_++] = value;
+    }
+    else
+    {
+      dropped_++;
+    }
+  }
+
+  T& operator[](size_t i)
+  {
+    return data_[i];
+  }
+
+  const T& operator[](size_t i) const
+  {
+    return data_[i];
+  }
+
+  T* data()
+  {
+    return data_;
+  }
+
+  const T* data() const
+  {
+    return data_;
+  }
+
+  size_t size() const
+  {
+    return size_;
+  }
+
+  size_t capacity() const
+  {
+    return capacity_;
+  }
+
+  size_t dropped() const
+  {
+    return dropped_;
+  }
+
+  void clear()
+  {
+    size_ = 0;
+    dropped_ = 0;
+  }
+
+  void reserve(size_t)
+  {
+  }
+
+  void resize(size_t num)
+  {
+    size_ = std::min(num, capacity_);
+  }
+
+private:
+
+  T* data_;
+  size_t capacity_;
+  size_t size_;
+  size_t dropped_;
+};
+
+//
+// Point cloud in layout of structure-of-arrays, on buffers provided by the caller. 
+// It is the output of the stateless decode(). Bind the arrays of interest 
+// before decoding, and leave the others unbound. xs must be bound.
+//
+class OutputSpan
+{
+public:
+
+  uint32_t height = 0;    ///< Height of point cloud
+  uint32_t width = 0;     ///< Width of point cloud
+  bool is_dense = false;  ///< If is_dense is true, the point cloud does not contain NAN points,
+  double timestamp = 0.0;
+  uint32_t seq = 0;       ///< Sequence number of message
+
+  SpanArray<float> xs;
+  SpanArray<float> ys;
+  SpanArray<float> zs;
+  SpanArray<uint8_t> intensities;
+  SpanArray<uint16_t> rings;
+  SpanArray<double> timestamps;
+
+  bool split = false;     ///< Split hint. true: a new frame starts in the packet
+  size_t split_index = 0; ///< Index of the first point of the new frame, if split is true
+  int error = 0;          ///< ErrCode of the last decode(). 0: ERRCODE_SUCCESS
+
+  size_t size() const
+  {
+    return xs.size();
+  }
+
+  bool overflow() const
+  {
+    return (xs.dropped() > 0);
+  }
+
+  void clear()
+  {
+    xs.clear();
+    ys.clear();
+    zs.clear();
+    intensities.clear();
+    rings.clear();
+    timestamps.clear();
+    split = false;
+    split_index = 0;
+    error = 0;
+  }
+
+  void reserve(size_t)
+  {
+  }
+
+  void resize(size_t num)
+  {
+    xs.resize(num);
+    ys.resize(num);
+    zs.resize(num);
+    intensities.resize(num);
+    rings.resize(num);
+    timestamps.resize(num);
+  }
+};
@@ -0,0 +1,298 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/common/rs_log.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+enum CloudPoolPolicy  ///< What to do if all clouds of the pool are in use
+{
+  POOL_REUSE_OLDEST = 0,  ///< Reuse the oldest stuffed cloud not taken by the consumer yet. Drop the frame if none
+  POOL_DROP,              ///< Drop the frame
+  POOL_WAIT               ///< Wait for the consumer to release a cloud, for at most wait_usec. Drop the frame then
+};
+
+//
+// Bounded pool of point clouds, which replaces the free queue and the stuffed queue of the caller.
+//
+// The clouds are allocated once, when the pool is constructed. The driver gets free clouds with get(), and 
+// puts stuffed clouds with put(). The consumer takes stuffed clouds with pop(). 
+// A cloud is free again as soon as the consumer drops its last reference. The control block of the shared_ptr is 
+// returned to the pool then, which wakes up get() waiting for it. The control blocks are allocated once per cloud, 
+// and reused, so no memory is allocated in steady state, and no thread spins.
+//
+template <typename T_PointCloud>
+class CloudPool
+{
+public:
+
+  CloudPool(size_t capacity, CloudPoolPolicy policy = POOL_REUSE_OLDEST, unsigned int wait_usec = 100000)
+    : policy_(policy), wait_usec_(wait_usec), state_(std::make_shared<State>()), head_(0), num_(0), dropped_(0)
+  {
+    if (capacity < 2)
+    {
+      // one cloud is either with the driver, or with the consumer. Then every other frame is lost.
+      RS_WARNING << "capacity of CloudPool should be at least 2. Use 2." << RS_REND;
+      capacity = 2;
+    }
+
+    state_->clouds.reserve(capacity);
+    for (size_t i = 0; i < capacity; i++)
+    {
+      state_->clouds.emplace_back(new T_PointCloud);
+    }
+    state_->blocks.resize(capacity);
+    state_->used.resize(capacity, false);
+    stuffed_.resize(capacity);
+  }
+
+  //
+  // for the driver. nullptr if no cloud is available, i.e. the frame is to be dropped.
+  //
+  std::shared_ptr<T_PointCloud> get()
+  {
+    std::unique_lock<std::mutex> ul(state_->mtx);
+
+    std::shared_ptr<T_PointCloud> cloud = getFree();
+    if (cloud)
+    {
+      return cloud;
+    }
+
+    if ((policy_ == POOL_REUSE_OLDEST) && (num_ > 0))
+    {
+      dropped_++;
+      return take();
+    }
+
+    if (policy_ == POOL_WAIT)
+    {
+      // woken up when a cloud is released.
+      state_->cv.wait_for(ul, std::chrono::microseconds(wait_usec_), [this, &cloud] { 
+          cloud = getFree(); 
+          return (cloud != nullptr); });
+      if (cloud)
+      {
+        return cloud;
+      }
+    }
+
+    dropped_++;
+    return nullptr;
+  }
+
+  //
+  // for the driver.
+  //
+  void put(std::shared_ptr<T_PointCloud> cloud)
+  {
+    std::shared_ptr<T_PointCloud> overwritten; // released out of the lock, since its deleter takes it.
+
+    {
+      std::lock_guard<std::mutex> lg(state_->mtx);
+      if (num_ == stuffed_.size()) // only if the cloud is not from the pool
+      {
+        dropped_++;
+        overwritten = take();
+      }
+
+      stuffed_[(head_ + num_) % stuffed_.size()] = std::move(cloud);
+      num_++;
+    }
+
+    state_->cv.notify_all();
+  }
+
+  //
+  // for the consumer. nullptr if no stuffed cloud in usec.
+  //
+  std::shared_ptr<T_PointCloud> pop(unsigned int usec = 1000000)
+  {
+    std::unique_lock<std::mutex> ul(state_->mtx);
+    if (!state_->cv.wait_for(ul, std::chrono::microseconds(usec), [this] { return (num_ > 0); }))
+    {
+      return nullptr;
+    }
+
+    return take();
+  }
+
+  size_t size()
+  {
+    std::lock_guard<std::mutex> lg(state_->mtx);
+    return num_;
+  }
+
+  size_t capacity() const
+  {
+    return state_->clouds.size();
+  }
+
+  uint64_t dropped()
+  {
+    std::lock_guard<std::mutex> lg(state_->mtx);
+    return dropped_;
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  //
+  // Shared by the pool and the clouds out of it, so a cloud may outlive the pool.
+  //
+  struct State
+  {
+    std::vector<std::unique_ptr<T_PointCloud>> clouds; // all clouds, allocated once
+    std::vector<std::unique_ptr<char[]>> blocks; // control blocks of the clouds, allocated on the first get()
+    std::vector<bool> used; // given out by get(), and not released yet
+    std::mutex mtx;
+    std::condition_variable cv;
+  };
+
+  //
+  // The clouds are owned by the pool, so the deleter does nothing. 
+  //
+  struct NoDelete
+  {
+    void operator()(T_PointCloud*)
+    {
+    }
+  };
+
+  //
+  // Allocator of the control block of the cloud idx. It is rebound by shared_ptr to the type of the control block,
+  // which is always the same. The cloud is released in deallocate(), after the control block is destroyed, 
+  // so it is not reused while the last reference is still being dropped.
+  //
+  template <typename U>
+  struct BlockAllocator
+  {
+    typedef U value_type;
+
+    std::shared_ptr<State> state;
+    size_t idx;
+
+    BlockAllocator(const std::shared_ptr<State>& s, size_t i)
+      : state(s), idx(i)
+    {
+    }
+
+    template <typename V>
+    BlockAllocator(const BlockAllocator<V>& other)
+      : state(other.state), idx(other.idx)
+    {
+    }
+
+    U* allocate(size_t n)
+    {
+      // called by getFree() under the lock
+      std::unique_ptr<char[]>& block = state->blocks[idx];
+      if (!block)
+      {
+        block.reset(new char[sizeof(U) * n]);
+      }
+
+      return reinterpret_cast<U*>(block.get());
+    }
+
+    void deallocate(U*, size_t)
+    {
+      {
+        std::lock_guard<std::mutex> lg(state->mtx);
+        state->used[idx] = false;
+      }
+
+      state->cv.notify_all();
+    }
+
+    template <typename V>
+    bool operator==(const BlockAllocator<V>& other) const
+    {
+      return (state == other.state) && (idx == other.idx);
+    }
+
+    template <typename V>
+    bool operator!=(const BlockAllocator<V>& other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  std::shared_ptr<T_PointCloud> getFree()
+  {
+    for (size_t i = 0; i < state_->clouds.size(); i++)
+    {
+      if (!state_->used[i])
+      {
+        state_->used[i] = true;
+        return std::shared_ptr<T_PointCloud>(state_->clouds[i].get(), NoDelete(), 
+            BlockAllocator<T_PointCloud>(state_, i));
+      }
+    }
+
+    return nullptr;
+  }
+
+  std::shared_ptr<T_PointCloud> take()
+  {
+    std::shared_ptr<T_PointCloud> cloud;
+    cloud.swap(stuffed_[head_]);
+    head_ = (head_ + 1) % stuffed_.size();
+    num_--;
+    return cloud;
+  }
+
+  const CloudPoolPolicy policy_;
+  const unsigned int wait_usec_;
+  std::shared_ptr<State> state_;
+  std::vector<std::shared_ptr<T_PointCloud>> stuffed_; // ring of stuffed clouds, not taken by the consumer yet
+  size_t head_;
+  size_t num_;
+  uint64_t dropped_; // frames dropped, or overwritten by POOL_REUSE_OLDEST
+};
+
+}  // namespace lidar
+}  // namespace robosense
@@ -0,0 +1,167 @@
+/*********************************************************************************************************************
+Copyright (c) 2020 RoboSense
+All rights reserved
+
+By downloading, copying, installing or using the software you agree to this license. If you do not agree to this
+license, do not download, install, copy or use the software.
+
+License Agreement
+For RoboSense LiDAR SDK Library
+(3-clause BSD License)
+
+Redistribution and use in source and binary forms, with or without modification, are permitted provided that the
+following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this list of conditions and the following
+disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice, this list of conditions and the following
+disclaimer in the documentation and/or other materials provided with the distribution.
+
+3. Neither the names of the RoboSense, nor Suteng Innovation Technology, nor the names of other contributors may be used
+to endorse or promote products derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*********************************************************************************************************************/
+
+
+#pragma once
+
+#include <rs_driver/msg/polar_point_cloud_msg.hpp>
+#include <rs_driver/driver/decoder/member_checker.hpp>
+#include <rs_driver/driver/decoder/point_batch.hpp>
+#include <rs_driver/driver/decoder/trigon.hpp>
+#include <rs_driver/driver/decoder/transform.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace robosense
+{
+namespace lidar
+{
+
+//
+// Calculate xyz of a PolarPointCloud on demand. A consumer filters points by distance/angle first, 
+// and then converts only the points it keeps, optionally with multiple threads.
+//
+class PolarCloudView
+{
+public:
+
+  PolarCloudView(const PolarPointCloud& cloud, const RSTransformParam& transform_param = RSTransformParam())
+    : cloud_(cloud)
+    , transform_(transform_param)
+#ifdef ENABLE_COMPACT_TRIGON
+    , trigon_(TrigonCompact::instance())
+#else
+    , trigon_(Trigon::instance())
+#endif
+  {
+  }
+
+  size_t size() const
+  {
+    return cloud_.size();
+  }
+
+  //
+  // RSE1/RSM2 give no angles (ANGLE_UNKNOWN), so xyz of their points can't be calculated. 
+  //
+  bool valid(size_t idx) const
+  {
+    return (cloud_.distances[idx] > 0.0f) && 
+      (cloud_.azimuths[idx] != PointBatch::ANGLE_UNKNOWN) && (cloud_.elevations[idx] != PointBatch::ANGLE_UNKNOWN);
+  }
+
+  double timestampAt(size_t idx) const
+  {
+    return cloud_.ts_base + cloud_.ts_offsets[idx];
+  }
+
+  void xyzAt(size_t idx, float& x, float& y, float& z) const
+  {
+    if (!valid(idx))
+    {
+      x = y = z = NAN;
+      return;
+    }
+
+    float distance = cloud_.distances[idx];
+    int32_t azimuth = cloud_.azimuths[idx];
+    int32_t elevation = cloud_.elevations[idx];
+
+    x =  distance * trigon_.cos(elevation) * trigon_.cos(azimuth) + cloud_.rx * trigon_.cos(azimuth);
+    y = -distance * trigon_.cos(elevation) * trigon_.sin(azimuth) - cloud_.rx * trigon_.sin(azimuth);
+    z =  distance * trigon_.sin(elevation) + cloud_.rz;
+
+    if (!transform_.isIdentity())
+    {
+      transform_.apply(x, y, z);
+    }
+  }
+
+  //
+  // convert the points of indices into a point cloud. the work is split evenly among threads.
+  //
+  template <typename T_PointCloud>
+  void toPointCloud(const std::vector<uint32_t>& indices, T_PointCloud& out, uint32_t threads = 1) const
+  {
+    size_t num = indices.size();
+    resizePoints(out, num);
+
+    if ((threads <= 1) || (num < threads))
+    {
+      convert(indices, out, 0, num);
+      return;
+    }
+
+    std::vector<std::thread> workers;
+    size_t step = (num + threads - 1) / threads;
+    for (size_t begin = 0; begin < num; begin += step)
+    {
+      size_t end = std::min(begin + step, num);
+      workers.emplace_back([this, &indices, &out, begin, end]() { convert(indices, out, begin, end); });
+    }
+
+    for (auto& w : workers)
+    {
+      w.join();
+    }
+  }
+
+#ifndef UNIT_TEST
+private:
+#endif
+
+  template <typename T_PointCloud>
+  void convert(const std::vector<uint32_t>& indices, T_PointCloud& out, size_t begin, size_t end) const
+  {
+    for (size_t i = begin; i < end; i++)
+    {
+      uint32_t idx = indices[i];
+
+      float x, y, z;
+      xyzAt(idx, x, y, z);
+      setPointAt(out, i, x, y, z, cloud_.intensities[idx], timestampAt(idx), cloud_.rings[idx]);
+    }
+  }
+
+  const PolarPointCloud& cloud_;
+  Transform transform_;
+#ifdef ENABLE_COMPACT_TRIGON
+  const TrigonCompact& trigon_;
+#else
+  const Trigon& trigon_;
+#endif
+};
+
+}  // namespace lidar
+}  // namespace robosense
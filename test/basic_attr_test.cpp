@@ -4,17 +4,158 @@
 #include <rs_driver/driver/decoder/basic_attr.hpp>
 #include <rs_driver/utility/dbg.hpp>
 
+#include <thread>
+
 using namespace robosense::lidar;
 
+//
+// run fn in the timezone tz, on a new thread, so that it starts with empty caches of parseTimeYMD/createTimeYMD.
+// POSIX TZ strings are used, which need no timezone database.
+//
+static void inTimezone(const char* tz, const std::function<void()>& fn)
+{
+  const char* old = getenv("TZ");
+  std::string old_tz = (old != NULL) ? old : "";
+
+  setenv("TZ", tz, 1);
+  tzset();
+
+  std::thread t(fn);
+  t.join();
+
+  if (old != NULL)
+  {
+    setenv("TZ", old_tz.c_str(), 1);
+  }
+  else
+  {
+    unsetenv("TZ");
+  }
+  tzset();
+}
+
+//
+// parseTimeYMD/createTimeYMD without the caches.
+//
+static uint64_t refParseTimeYMD(const RSTimestampYMD* tsYmd)
+{
+  std::tm stm;
+  memset(&stm, 0, sizeof(stm));
+  stm.tm_year = tsYmd->year + (2000 - 1900);
+  stm.tm_mon = tsYmd->month - 1;
+  stm.tm_mday = tsYmd->day;
+  stm.tm_hour = tsYmd->hour;
+  stm.tm_min = tsYmd->minute;
+  stm.tm_sec = tsYmd->second;
+  time_t sec = std::mktime(&stm);
+
+  return (sec * 1000000 + ntohs(tsYmd->ms) * 1000 + ntohs(tsYmd->us));
+}
+
+static void refCreateTimeYMD(uint64_t usec, RSTimestampYMD* tsYmd)
+{
+  time_t sec = usec / 1000000;
+  std::tm stm;
+  localtime_r(&sec, &stm);
+
+  tsYmd->year = stm.tm_year - (2000 - 1900);
+  tsYmd->month = stm.tm_mon + 1;
+  tsYmd->day = stm.tm_mday;
+  tsYmd->hour = stm.tm_hour;
+  tsYmd->minute = stm.tm_min;
+  tsYmd->second = stm.tm_sec;
+  tsYmd->ms = htons((uint16_t)(usec / 1000 % 1000));
+  tsYmd->us = htons((uint16_t)(usec % 1000));
+}
+
+//
+// compare with the uncached versions, for times in [sec - 2h, sec + 2h], forward and then backward.
+//
+static void checkAround(time_t sec)
+{
+  std::vector<uint64_t> usecs;
+  for (int64_t off = -7200; off <= 7200; off += 433)
+  {
+    usecs.push_back((sec + off) * 1000000 + 123456);
+  }
+  std::vector<uint64_t> rusecs(usecs.rbegin(), usecs.rend());
+  usecs.insert(usecs.end(), rusecs.begin(), rusecs.end());
+
+  for (uint64_t usec : usecs)
+  {
+    RSTimestampYMD ts, ref;
+    createTimeYMD(usec, &ts);
+    refCreateTimeYMD(usec, &ref);
+    ASSERT_EQ(memcmp(&ts, &ref, sizeof(ts)), 0) << "usec:" << usec;
+    ASSERT_EQ(parseTimeYMD(&ts), refParseTimeYMD(&ts)) << "usec:" << usec;
+  }
+}
+
 TEST(TestParseTime, parseTimeYMD)
 {
-  uint8_t ts1[] = {0x15, 0x0a, 0x01, 0x01, 0x02, 0x03, 0x01, 0x11, 0x02, 0x22};
-  uint8_t ts2[10];
+  inTimezone("CST-8", []()
+      {
+        uint8_t ts1[] = {0x15, 0x0a, 0x01, 0x01, 0x02, 0x03, 0x01, 0x11, 0x02, 0x22};
+        uint8_t ts2[10];
 
-  ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts1), 1633021323273546);
+        ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts1), 1633021323273546);
 
-  createTimeYMD(1633021323273546, (RSTimestampYMD*)ts2);
-  ASSERT_EQ(memcmp(ts2, ts1, 10), 0);
+        createTimeYMD(1633021323273546, (RSTimestampYMD*)ts2);
+        ASSERT_EQ(memcmp(ts2, ts1, 10), 0);
+      });
+}
+
+TEST(TestParseTime, parseTimeYMDAcrossHours)
+{
+  inTimezone("CST-8", []()
+      {
+        // 01:59:59, 02:00:00, and 01:02:03 again
+        uint8_t ts1[] = {0x15, 0x0a, 0x01, 0x01, 0x3b, 0x3b, 0x00, 0x00, 0x00, 0x00};
+        uint8_t ts2[] = {0x15, 0x0a, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+        uint8_t ts3[] = {0x15, 0x0a, 0x01, 0x01, 0x02, 0x03, 0x01, 0x11, 0x02, 0x22};
+        uint8_t ts4[10];
+
+        ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts1), 1633024799000000);
+        ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts2), 1633024800000000);
+        ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts3), 1633021323273546);
+
+        createTimeYMD(1633024799000000, (RSTimestampYMD*)ts4);
+        ASSERT_EQ(memcmp(ts4, ts1, 10), 0);
+        createTimeYMD(1633024800000000, (RSTimestampYMD*)ts4);
+        ASSERT_EQ(memcmp(ts4, ts2, 10), 0);
+        createTimeYMD(1633021323273546, (RSTimestampYMD*)ts4);
+        ASSERT_EQ(memcmp(ts4, ts3, 10), 0);
+
+        checkAround(1633024800);
+      });
+}
+
+TEST(TestParseTime, parseTimeYMDAcrossDst)
+{
+  inTimezone("EST5EDT,M3.2.0,M11.1.0", []()
+      {
+        checkAround(1615705200); // 2021-03-14 02:00 EST -> 03:00 EDT
+        checkAround(1636264800); // 2021-11-07 02:00 EDT -> 01:00 EST
+      });
+}
+
+TEST(TestParseTime, parseTimeYMDHalfHourOffset)
+{
+  inTimezone("IST-5:30", []()
+      {
+        // 2021-10-01 01:02:03 in UTC+5:30
+        uint8_t ts1[] = {0x15, 0x0a, 0x01, 0x01, 0x02, 0x03, 0x01, 0x11, 0x02, 0x22};
+        ASSERT_EQ(parseTimeYMD((RSTimestampYMD*)ts1), 1633021323273546 + 9000000000);
+
+        checkAround(1633024800);
+      });
+
+  // daylight saving time of half an hour
+  inTimezone("<+1030>-10:30<+11>-11,M10.1.0,M4.1.0", []()
+      {
+        checkAround(1633188600); // 2021-10-03 02:00 +1030 -> 02:30 +11
+        checkAround(1617462000); // 2021-04-04 02:00 +11 -> 01:30 +1030
+      });
 }
 
 #if 0
@@ -0,0 +1,131 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/utility/cloud_pool.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+
+#include <thread>
+
+using namespace robosense::lidar;
+
+typedef PointCloudT<PointXYZIRT> PointCloud;
+
+TEST(TestCloudPool, getPut)
+{
+  CloudPool<PointCloud> pool(2, POOL_DROP);
+  ASSERT_EQ(pool.capacity(), 2);
+
+  std::shared_ptr<PointCloud> c1 = pool.get();
+  std::shared_ptr<PointCloud> c2 = pool.get();
+  ASSERT_TRUE(c1 != nullptr);
+  ASSERT_TRUE(c2 != nullptr);
+  ASSERT_NE(c1, c2);
+  ASSERT_TRUE(pool.get() == nullptr); // exhausted
+  ASSERT_EQ(pool.dropped(), 1);
+
+  c1->seq = 1;
+  pool.put(c1);
+  ASSERT_EQ(pool.size(), 1);
+  ASSERT_TRUE(pool.get() == nullptr); // stuffed, not popped yet
+
+  PointCloud* raw = c1.get();
+  c1.reset();
+  std::shared_ptr<PointCloud> msg = pool.pop(0);
+  ASSERT_EQ(msg->seq, 1);
+  ASSERT_EQ(pool.size(), 0);
+  ASSERT_TRUE(pool.pop(0) == nullptr);
+
+  // released by the consumer
+  msg.reset();
+  std::shared_ptr<PointCloud> c3 = pool.get();
+  ASSERT_EQ(c3.get(), raw);
+}
+
+TEST(TestCloudPool, reuseOldest)
+{
+  CloudPool<PointCloud> pool(2, POOL_REUSE_OLDEST);
+
+  std::shared_ptr<PointCloud> c1 = pool.get();
+  c1->seq = 1;
+  pool.put(c1);
+  std::shared_ptr<PointCloud> c2 = pool.get();
+  c2->seq = 2;
+  pool.put(c2);
+  c1.reset();
+  c2.reset();
+
+  std::shared_ptr<PointCloud> c3 = pool.get();
+  ASSERT_EQ(c3->seq, 1); // the oldest one
+  ASSERT_EQ(pool.size(), 1);
+  ASSERT_EQ(pool.dropped(), 1);
+  ASSERT_EQ(pool.pop(0)->seq, 2);
+}
+
+TEST(TestCloudPool, wait)
+{
+  CloudPool<PointCloud> pool(2, POOL_WAIT, 10000000);
+
+  std::shared_ptr<PointCloud> c0 = pool.get();
+  std::shared_ptr<PointCloud> c1 = pool.get();
+  std::thread t([&c1]() 
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        c1.reset();
+      });
+
+  auto start = std::chrono::steady_clock::now();
+  std::shared_ptr<PointCloud> c2 = pool.get();
+  t.join();
+  ASSERT_TRUE(c2 != nullptr);
+  ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5)); // woken up by the release
+
+  CloudPool<PointCloud> pool2(2, POOL_WAIT, 1000);
+  std::shared_ptr<PointCloud> c3 = pool2.get();
+  std::shared_ptr<PointCloud> c4 = pool2.get();
+  ASSERT_TRUE(pool2.get() == nullptr); // timeout
+  ASSERT_EQ(pool2.dropped(), 1);
+}
+
+TEST(TestCloudPool, capacity)
+{
+  CloudPool<PointCloud> pool(0, POOL_DROP);
+  ASSERT_EQ(pool.capacity(), 2);
+
+  CloudPool<PointCloud> pool1(1, POOL_DROP);
+  ASSERT_EQ(pool1.capacity(), 2);
+}
+
+TEST(TestCloudPool, outlivePool)
+{
+  std::shared_ptr<PointCloud> c1;
+  {
+    CloudPool<PointCloud> pool(2, POOL_DROP);
+    c1 = pool.get();
+    pool.put(pool.get());
+  }
+
+  c1->seq = 1;
+  c1.reset();
+}
+
+TEST(TestCloudPool, reuseControlBlock)
+{
+  CloudPool<PointCloud> pool(2, POOL_DROP);
+
+  std::shared_ptr<PointCloud> c1 = pool.get();
+  PointCloud* cloud = c1.get();
+  const char* block = pool.state_->blocks[0].get();
+  ASSERT_TRUE(block != nullptr);
+  c1.reset();
+
+  // the same cloud, with the same control block
+  for (int i = 0; i < 10; i++)
+  {
+    pool.put(pool.get());
+    c1 = pool.pop(0);
+    ASSERT_EQ(c1.get(), cloud);
+    ASSERT_EQ(pool.state_->blocks[0].get(), block);
+    ASSERT_TRUE(pool.state_->blocks[1] == nullptr);
+    c1.reset();
+  }
+}
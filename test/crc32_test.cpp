@@ -0,0 +1,55 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/crc32.hpp>
+
+using namespace robosense::lidar;
+
+TEST(TestCrc32, crc32Update)
+{
+  uint8_t data[1300];
+  for (size_t i = 0; i < sizeof(data); i++)
+  {
+    data[i] = (uint8_t)(i * 37 + (i >> 3));
+  }
+
+  Crc32Impl impls[] = {CRC32_BYTEWISE, CRC32_SLICING8, CRC32_SLICING16, CRC32_ARMV8, CRC32_PCLMUL};
+  for (auto impl : impls)
+  {
+    if (!isCrc32ImplSupported(impl))
+    {
+      continue;
+    }
+
+    for (size_t len = 0; len < 200; len++)
+    {
+      uint32_t expected = calcCrc32(data + 3, (uint32_t)len, 0, true);
+      ASSERT_EQ(crc32Update(impl, 0xFFFFFFFF, data + 3, len) ^ 0xFFFFFFFF, expected);
+    }
+
+    uint32_t expected = calcCrc32(data, sizeof(data), 0, true);
+    ASSERT_EQ(crc32Update(impl, 0xFFFFFFFF, data, sizeof(data)) ^ 0xFFFFFFFF, expected);
+  }
+
+  // "123456789"
+  const uint8_t check[] = {0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39};
+  ASSERT_EQ(crc32Update(bestCrc32Impl(), 0xFFFFFFFF, check, sizeof(check)) ^ 0xFFFFFFFF, 0xCBF43926);
+}
+
+TEST(TestCrc32, isCrc32Correct)
+{
+  uint8_t pkt[1210];
+  for (size_t i = 0; i < sizeof(pkt); i++)
+  {
+    pkt[i] = (uint8_t)(i * 13);
+  }
+
+  uint32_t crc = calcCrc32(pkt, sizeof(pkt) - 6, 0, true);
+  crc = calcCrc32(pkt + sizeof(pkt) - 2, 2, crc, false);
+  crc = htonl(crc);
+  memcpy(pkt + sizeof(pkt) - 6, &crc, 4);
+  ASSERT_TRUE(isCrc32Correct(pkt, sizeof(pkt)));
+
+  pkt[100] ^= 0x01;
+  ASSERT_FALSE(isCrc32Correct(pkt, sizeof(pkt)));
+}
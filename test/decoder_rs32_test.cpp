@@ -66,6 +66,7 @@ TEST(TestDecoderRS32, decodeDifopPkt)
   decoder.regCallback(errCallback, nullptr);
   ASSERT_EQ(decoder.blks_per_frame_, 1801);
   ASSERT_EQ(decoder.split_blks_per_frame_, 1801);
+  ASSERT_EQ(decoder.getMaxPointsPerFrame(), 1801 * 32);
 
   // rpm = 600, dual return
   RS32DifopPkt pkt;
@@ -76,6 +77,7 @@ TEST(TestDecoderRS32, decodeDifopPkt)
   ASSERT_EQ(decoder.echo_mode_, RSEchoMode::ECHO_DUAL);
   ASSERT_EQ(decoder.blks_per_frame_, 1801);
   ASSERT_EQ(decoder.split_blks_per_frame_, 3602);
+  ASSERT_EQ(decoder.getMaxPointsPerFrame(), 3602 * 32);
 
   // rpm = 1200, single return
   pkt.rpm = htons(1200);
@@ -87,6 +89,33 @@ TEST(TestDecoderRS32, decodeDifopPkt)
   ASSERT_EQ(decoder.split_blks_per_frame_, 900);
 }
 
+TEST(TestDecoderRS32, splitStrategy)
+{
+  RSDecoderParam param;
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_FIXED_BLKS;
+  DecoderRS32<PointCloud, SplitStrategyByNum> decoder(param);
+  ASSERT_EQ(decoder.split_strategy_.max_blks_, 1801);
+
+  // dual return
+  RS32DifopPkt pkt;
+  pkt.rpm = htons(600);
+  pkt.return_mode = 0;
+  decoder.decodeDifopPkt((uint8_t*)&pkt, sizeof(pkt));
+  ASSERT_EQ(decoder.split_strategy_.max_blks_, 3602);
+
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_CUSTOM_BLKS;
+  DecoderRS32<PointCloud, SplitStrategyByNum> decoder2(param);
+  ASSERT_EQ(decoder2.split_strategy_.max_blks_, decoder2.param_.num_blks_split);
+  decoder2.decodeDifopPkt((uint8_t*)&pkt, sizeof(pkt));
+  ASSERT_EQ(decoder2.split_strategy_.max_blks_, decoder2.param_.num_blks_split);
+  ASSERT_EQ(decoder2.getMaxPointsPerFrame(), decoder2.param_.num_blks_split * 32);
+
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_ANGLE;
+  param.split_angle = 90.0f;
+  DecoderRS32<PointCloud> decoder3(param);
+  ASSERT_EQ(decoder3.split_strategy_.split_angle_, 9000);
+}
+
 static void splitFrame(uint16_t height, double ts)
 {
 }
@@ -202,5 +231,20 @@ TEST(TestDecoderRS32, decodeMsopPkt)
   ASSERT_EQ(point.intensity, 1);
   ASSERT_NE(point.timestamp, 0);
   ASSERT_EQ(point.ring, 2);
+
+  // ring 2 is masked, before xyz is calculated.
+  param.ring_azimuth_mask.azimuth_bins = 1;
+  param.ring_azimuth_mask.masked = {0, 0, 1};
+  DecoderRS32<PointCloud> decoder2(param);
+  decoder2.regCallback(errCallback, splitFrame);
+  decoder2.chan_angles_.user_chans_[0] = 2;
+  decoder2.chan_angles_.user_chans_[1] = 1;
+  decoder2.point_cloud_ = std::make_shared<PointCloud>();
+
+  decoder2.decodeMsopPkt(pkt, sizeof(pkt));
+  ASSERT_EQ(decoder2.point_cloud_->points.size(), 32);
+  ASSERT_TRUE(std::isnan(decoder2.point_cloud_->points[0].x));
+  ASSERT_EQ(decoder2.point_cloud_->points[0].intensity, 0);
+  ASSERT_EQ(decoder2.point_cloud_->points[0].ring, 2);
 }
 
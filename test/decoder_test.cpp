@@ -2,7 +2,12 @@
 #include <gtest/gtest.h>
 
 #include <rs_driver/driver/decoder/decoder_mech.hpp>
+#include <rs_driver/driver/decoder/decoder_RS16.hpp>
+#include <rs_driver/driver/decoder/decoder_RS32.hpp>
+#include <rs_driver/driver/decoder/decoder_RSM1.hpp>
 #include <rs_driver/msg/point_cloud_msg.hpp>
+#include <rs_driver/msg/range_image_msg.hpp>
+#include <rs_driver/msg/polar_point_cloud_msg.hpp>
 #include <rs_driver/utility/dbg.hpp>
 
 using namespace robosense::lidar;
@@ -48,6 +53,44 @@ public:
 
 };
 
+class MyRangeImageDecoder : public DecoderMech<RangeImage>
+{
+public:
+  MyRangeImageDecoder(const RSDecoderMechConstParam& const_param,
+      const RSDecoderParam& param)
+  : DecoderMech<RangeImage>(const_param, param)
+  {
+  }
+
+  virtual void decodeDifopPkt(const uint8_t* packet, size_t size)
+  {
+  }
+
+  virtual bool decodeMsopPkt(const uint8_t* pkt, size_t size)
+  {
+    return false;
+  }
+};
+
+class MyPolarDecoder : public DecoderMech<PolarPointCloud>
+{
+public:
+  MyPolarDecoder(const RSDecoderMechConstParam& const_param,
+      const RSDecoderParam& param)
+  : DecoderMech<PolarPointCloud>(const_param, param)
+  {
+  }
+
+  virtual void decodeDifopPkt(const uint8_t* packet, size_t size)
+  {
+  }
+
+  virtual bool decodeMsopPkt(const uint8_t* pkt, size_t size)
+  {
+    return false;
+  }
+};
+
 static ErrCode errCode = ERRCODE_SUCCESS;
 
 static void errCallback(const Error& err)
@@ -285,3 +328,715 @@ TEST(TestDecoder, processMsopPkt)
   ASSERT_EQ(errCode, ERRCODE_SUCCESS);
 }
 
+
+TEST(TestDecoder, splitModeMismatch)
+{
+  // the default split strategy is by angle
+  RSDecoderParam param;
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_CUSTOM_BLKS;
+  DecoderRS16<PointCloud> decoder(param);
+  ASSERT_EQ(decoder.param_.split_frame_mode, SplitFrameMode::SPLIT_BY_ANGLE);
+
+  DecoderRS16<PointCloud, SplitStrategyByNum> decoder2(param);
+  ASSERT_EQ(decoder2.param_.split_frame_mode, SplitFrameMode::SPLIT_BY_CUSTOM_BLKS);
+
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_ANGLE;
+  DecoderRS16<PointCloud, SplitStrategyByNum> decoder3(param);
+  ASSERT_EQ(decoder3.param_.split_frame_mode, SplitFrameMode::SPLIT_BY_FIXED_BLKS);
+}
+
+TEST(TestDecoder, sharedTrigon)
+{
+  RSDecoderMechConstParam const_param;
+  RSDecoderParam param;
+  MyDecoder decoder1(const_param, param);
+  MyDecoder decoder2(const_param, param);
+  ASSERT_EQ(&decoder1.trigon_, &decoder2.trigon_);
+}
+
+TEST(TestDecoder, getMaxPointsPerFrame_mems)
+{
+  RSDecoderParam param;
+  DecoderRSM1<PointCloud> decoder(param);
+  ASSERT_EQ(decoder.getMaxPointsPerFrame(), 630 * 25 * 5);
+
+  // a time window of half a frame, and the packet across its end
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_TIME;
+  param.split_period = 0.05;
+  DecoderRSM1<PointCloud> decoder2(param);
+  size_t pkts = decoder2.getMaxPointsPerFrame() / (25 * 5);
+  ASSERT_GE(pkts, 316);
+  ASSERT_LE(pkts, 317);
+}
+
+TEST(TestDecoder, getMaxPointsPerFrameAnyEcho)
+{
+  RSDecoderParam param;
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_TIME;
+  param.split_period = 0.1;
+
+  // frames of RS32 are doubled in dual return mode
+  DecoderRS32<PointCloud, SplitStrategyByTime> rs32(param);
+  size_t single = rs32.getMaxPointsPerFrame();
+  ASSERT_EQ(rs32.getMaxPointsPerFrameAnyEcho(), single * 2);
+
+  RS32DifopPkt rs32_difop;
+  memset(&rs32_difop, 0, sizeof(rs32_difop));
+  rs32_difop.rpm = htons(600);
+  rs32_difop.return_mode = 0x00;
+  rs32.decodeDifopPkt((const uint8_t*)&rs32_difop, sizeof(rs32_difop));
+  ASSERT_EQ(rs32.getMaxPointsPerFrame(), single * 2);
+  ASSERT_EQ(rs32.getMaxPointsPerFrameAnyEcho(), single * 2);
+
+  // frames of RS16 are not larger in dual return mode
+  DecoderRS16<PointCloud, SplitStrategyByTime> rs16(param);
+  size_t dual = rs16.getMaxPointsPerFrame();
+  ASSERT_EQ(rs16.getMaxPointsPerFrameAnyEcho(), dual);
+
+  RS16DifopPkt rs16_difop;
+  memset(&rs16_difop, 0, sizeof(rs16_difop));
+  rs16_difop.rpm = htons(600);
+  rs16_difop.return_mode = 0x00;
+  rs16.decodeDifopPkt((const uint8_t*)&rs16_difop, sizeof(rs16_difop));
+  ASSERT_EQ(rs16.getMaxPointsPerFrame(), dual);
+  ASSERT_EQ(rs16.getMaxPointsPerFrameAnyEcho(), dual);
+}
+
+TEST(TestDecoder, flushBatch)
+{
+  RSDecoderMechConstParam const_param;
+  RSDecoderParam param;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  // not dense. NaN points are kept.
+  decoder.param_.dense_points = false;
+  decoder.batch_.push(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  decoder.batch_.pushNan(0.0, 1);
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.batch_.size(), 0);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.point_cloud_->points[0].x, 1.0f);
+  ASSERT_EQ(decoder.point_cloud_->points[0].intensity, 100);
+  ASSERT_TRUE(std::isnan(decoder.point_cloud_->points[1].x));
+
+  // dense. NaN points are not even staged.
+  param.dense_points = true;
+  MyDecoder decoder2(const_param, param);
+  decoder2.point_cloud_ = std::make_shared<PointCloud>();
+  decoder2.batch_.push(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  decoder2.batch_.pushNan(0.0, 1);
+  ASSERT_EQ(decoder2.batch_.size(), 1);
+  decoder2.flushBatch();
+  ASSERT_EQ(decoder2.point_cloud_->points.size(), 1);
+  ASSERT_EQ(decoder2.point_cloud_->points[0].z, 3.0f);
+
+  // dense, and points to be paired in dual return mode. NaN points are staged, and dropped.
+  param.dual_return_mode = DUAL_RETURN_STRONGEST;
+  MyDecoder decoder3(const_param, param);
+  decoder3.point_cloud_ = std::make_shared<PointCloud>();
+  decoder3.batch_.push(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  decoder3.batch_.pushNan(0.0, 1);
+  ASSERT_EQ(decoder3.batch_.size(), 2);
+  decoder3.flushBatch();
+  ASSERT_EQ(decoder3.point_cloud_->points.size(), 1);
+}
+
+TEST(TestDecoder, pushPoint_direct)
+{
+  RSDecoderMechConstParam const_param;
+  RSDecoderParam param;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  // no stage of batch. points are written into the cloud directly.
+  ASSERT_TRUE(decoder.direct_);
+  decoder.pushPoint(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  decoder.pushNanPoint(0.0, 1);
+  ASSERT_EQ(decoder.batch_.size(), 0);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.point_cloud_->points[0].x, 1.0f);
+  ASSERT_TRUE(std::isnan(decoder.point_cloud_->points[1].x));
+
+  // dense
+  param.dense_points = true;
+  MyDecoder decoder2(const_param, param);
+  decoder2.point_cloud_ = std::make_shared<PointCloud>();
+  ASSERT_TRUE(decoder2.direct_);
+  decoder2.pushPoint(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  decoder2.pushNanPoint(0.0, 1);
+  ASSERT_EQ(decoder2.point_cloud_->points.size(), 1);
+
+  // the pose callback deskews points of the batch.
+  decoder2.regPoseCallback([](double ts, RSPose& pose) -> bool { return false; });
+  ASSERT_FALSE(decoder2.direct_);
+  decoder2.pushPoint(1.0f, 2.0f, 3.0f, 100, 0.0, 0);
+  ASSERT_EQ(decoder2.batch_.size(), 1);
+  ASSERT_EQ(decoder2.point_cloud_->points.size(), 1);
+
+  // any stage of batch
+  param.transform_param.x = 1.0f;
+  ASSERT_FALSE(MyDecoder(const_param, param).direct_);
+  param.transform_param.x = 0.0f;
+  param.voxel_size = 0.1f;
+  ASSERT_FALSE(MyDecoder(const_param, param).direct_);
+  param.voxel_size = 0.0f;
+  param.dual_return_mode = DUAL_RETURN_STRONGEST;
+  ASSERT_FALSE(MyDecoder(const_param, param).direct_);
+  param.dual_return_mode = DUAL_RETURN_ALL;
+  param.crop_boxes.resize(1);
+  ASSERT_FALSE(MyDecoder(const_param, param).direct_);
+  param.crop_boxes.clear();
+  param.dense_points = false;
+  param.organized = true;
+  ASSERT_FALSE(MyDecoder(const_param, param).direct_);
+}
+
+TEST(TestDecoder, flushBatch_organized)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+  const_param.base.CHANNELS_PER_BLOCK = 2;
+  const_param.BLOCK_DURATION = 1.0 / 30; // 3 blocks per frame
+
+  RSDecoderParam param;
+  param.organized = true;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+  ASSERT_EQ(decoder.getMaxPointsPerFrame(), 6);
+
+  // column 0
+  decoder.batch_.push(1.0f, 1.0f, 1.0f, 10, 0.0, 1);
+  decoder.batch_.push(2.0f, 2.0f, 2.0f, 20, 0.0, 0);
+  // column 1
+  decoder.batch_.pushNan(0.0, 1);
+  decoder.batch_.push(3.0f, 3.0f, 3.0f, 30, 0.0, 0);
+  decoder.flushBatch();
+
+  PointCloud& cloud = *decoder.point_cloud_;
+  ASSERT_EQ(cloud.points.size(), 6);
+  ASSERT_EQ(decoder.frame_width_, 3);
+
+  ASSERT_EQ(cloud.points[0].x, 2.0f); // [0][0]
+  ASSERT_EQ(cloud.points[1].x, 3.0f); // [0][1]
+  ASSERT_TRUE(std::isnan(cloud.points[2].x)); // [0][2]
+  ASSERT_EQ(cloud.points[3].x, 1.0f); // [1][0]
+  ASSERT_TRUE(std::isnan(cloud.points[4].x)); // [1][1]
+  ASSERT_TRUE(std::isnan(cloud.points[5].x)); // [1][2]
+
+  // column 2, and column 3 beyond the expected width. the grid grows.
+  decoder.regCallback(errCallback, nullptr);
+  errCode = ERRCODE_SUCCESS;
+  decoder.batch_.push(4.0f, 4.0f, 4.0f, 40, 0.0, 1);
+  decoder.batch_.pushNan(0.0, 0);
+  decoder.batch_.push(5.0f, 5.0f, 5.0f, 50, 0.0, 0);
+  decoder.flushBatch();
+  ASSERT_EQ(cloud.points.size(), 8);
+  ASSERT_EQ(decoder.frame_width_, 3);
+  ASSERT_EQ(errCode, ERRCODE_SUCCESS);
+
+  ASSERT_EQ(cloud.points[0].x, 2.0f); // [0][0]
+  ASSERT_EQ(cloud.points[1].x, 3.0f); // [0][1]
+  ASSERT_TRUE(std::isnan(cloud.points[2].x)); // [0][2]
+  ASSERT_EQ(cloud.points[3].x, 5.0f); // [0][3]
+  ASSERT_EQ(cloud.points[4].x, 1.0f); // [1][0]
+  ASSERT_EQ(cloud.points[6].x, 4.0f); // [1][2]
+  ASSERT_TRUE(std::isnan(cloud.points[7].x)); // [1][3]
+
+  // up to twice the expected width. the others are dropped.
+  for (int i = 0; i < 6; i++)
+  {
+    decoder.batch_.push(6.0f, 6.0f, 6.0f, 60, 0.0, 0);
+  }
+  decoder.flushBatch();
+  ASSERT_EQ(cloud.points.size(), 12);
+  ASSERT_EQ(cloud.points[5].x, 6.0f); // [0][5]
+  ASSERT_EQ(cloud.points[6].x, 1.0f); // [1][0]
+  ASSERT_EQ(errCode, ERRCODE_CLOUDOVERFLOW);
+
+  // dense_points overrides organized
+  param.dense_points = true;
+  MyDecoder decoder2(const_param, param);
+  ASSERT_FALSE(decoder2.param_.organized);
+}
+
+TEST(TestDecoder, flushBatch_rangeImage)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+  const_param.base.CHANNELS_PER_BLOCK = 2;
+  const_param.base.DISTANCE_RES = 0.005f;
+  const_param.BLOCK_DURATION = 1.0 / 30; // 3 blocks per frame
+
+  RSDecoderParam param;
+  MyRangeImageDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<RangeImage>();
+  ASSERT_FALSE(decoder.XYZ);
+  ASSERT_TRUE(MyDecoder::XYZ);
+
+  // column 0
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 10, 0.1, 1, 1.0f, 100, 150);
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 20, 0.1, 0, 2.0f, 100, -150);
+  // column 1
+  decoder.batch_.pushNan(0.2, 1);
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 30, 0.2, 0, 3.0f, 200, -150);
+  decoder.flushBatch();
+
+  RangeImage& image = *decoder.point_cloud_;
+  ASSERT_EQ(image.size(), 6);
+  ASSERT_EQ(image.col_timestamps.size(), 3);
+  ASSERT_EQ(image.row_vert_angles.size(), 2);
+  ASSERT_EQ(image.distance_res, 0.005f);
+
+  ASSERT_EQ(image.distances[0], 400); // [0][0]
+  ASSERT_EQ(image.distances[1], 600); // [0][1]
+  ASSERT_EQ(image.distances[2], 0);   // [0][2]
+  ASSERT_EQ(image.distances[3], 200); // [1][0]
+  ASSERT_EQ(image.distances[4], 0);   // [1][1]
+  ASSERT_EQ(image.intensities[1], 30);
+  ASSERT_EQ(image.intensities[4], 0);
+
+  ASSERT_EQ(image.col_timestamps[0], 0.1);
+  ASSERT_EQ(image.col_timestamps[1], 0.2);
+  ASSERT_EQ(image.col_timestamps[2], 0.0);
+  ASSERT_FLOAT_EQ(image.row_vert_angles[0], -1.5f);
+  ASSERT_FLOAT_EQ(image.row_vert_angles[1], 1.5f);
+
+  // column 2, and column 3 beyond the expected width. the image grows.
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 40, 0.3, 1, 4.0f, 300, 150);
+  decoder.batch_.pushNan(0.3, 0);
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 50, 0.4, 0, 5.0f, 400, -150);
+  decoder.flushBatch();
+  ASSERT_EQ(image.size(), 8);
+  ASSERT_EQ(image.col_timestamps.size(), 4);
+  ASSERT_EQ(image.distances[0], 400); // [0][0]
+  ASSERT_EQ(image.distances[1], 600); // [0][1]
+  ASSERT_EQ(image.distances[3], 1000); // [0][3]
+  ASSERT_EQ(image.distances[4], 200); // [1][0]
+  ASSERT_EQ(image.distances[6], 800); // [1][2]
+  ASSERT_EQ(image.distances[7], 0);   // [1][3]
+  ASSERT_EQ(image.intensities[4], 10);
+  ASSERT_EQ(image.col_timestamps[3], 0.4);
+
+  // no angles given (such as RSE1/RSM2)
+  image.clear();
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 10, 0.1, 0, 1.0f);
+  decoder.flushBatch();
+  ASSERT_EQ(image.distances[0], 200);
+  ASSERT_TRUE(std::isnan(image.row_vert_angles[0]));
+}
+
+TEST(TestDecoder, flushBatch_polar)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+  const_param.RX = 0.1f;
+  const_param.RZ = 0.2f;
+
+  RSDecoderParam param;
+  param.organized = true;
+  MyPolarDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PolarPointCloud>();
+  ASSERT_FALSE(decoder.XYZ);
+  ASSERT_FALSE(decoder.param_.organized);
+
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f, 100, 150);
+  decoder.batch_.pushNan(1.5, 1);
+  decoder.flushBatch();
+
+  PolarPointCloud& cloud = *decoder.point_cloud_;
+  ASSERT_EQ(cloud.size(), 2);
+  ASSERT_EQ(cloud.ts_base, 1.0);
+  ASSERT_EQ(cloud.rx, 0.1f);
+  ASSERT_EQ(cloud.rz, 0.2f);
+  ASSERT_EQ(cloud.distances[0], 1.0f);
+  ASSERT_EQ(cloud.azimuths[0], 100);
+  ASSERT_EQ(cloud.elevations[0], 150);
+  ASSERT_EQ(cloud.intensities[0], 10);
+  ASSERT_EQ(cloud.distances[1], 0.0f);
+  ASSERT_EQ(cloud.rings[1], 1);
+  ASSERT_EQ(cloud.ts_offsets[1], 0.5f);
+
+  // a new frame, in dense mode. invalid points are dropped.
+  cloud.clear();
+  decoder.new_frame_ = true;
+  decoder.param_.dense_points = true;
+  decoder.batch_.pushNan(2.0, 1);
+  decoder.batch_.push(0.0f, 0.0f, 0.0f, 10, 2.5, 0, 1.0f, 100, 150);
+  decoder.flushBatch();
+  ASSERT_EQ(cloud.size(), 1);
+  ASSERT_EQ(cloud.ts_base, 2.0);
+  ASSERT_EQ(cloud.ts_offsets[0], 0.5f);
+}
+
+TEST(TestDecoder, flushBatch_tsOffset)
+{
+  typedef PointCloudT<PointXYZIRTOffset> OffsetCloud;
+
+  class MyOffsetDecoder : public DecoderMech<OffsetCloud>
+  {
+  public:
+    MyOffsetDecoder(const RSDecoderMechConstParam& const_param, const RSDecoderParam& param)
+      : DecoderMech<OffsetCloud>(const_param, param)
+    {
+    }
+
+    virtual void decodeDifopPkt(const uint8_t* packet, size_t size) {}
+    virtual bool decodeMsopPkt(const uint8_t* pkt, size_t size) { return false; }
+  };
+
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  MyOffsetDecoder decoder(const_param, param);
+  ASSERT_TRUE(decoder.TS_OFFSET);
+  ASSERT_FALSE(MyDecoder::TS_OFFSET);
+
+  double cloud_ts = 0.0;
+  decoder.regCallback(errCallback, [&cloud_ts](uint16_t height, double ts) { cloud_ts = ts; });
+  decoder.point_cloud_ = std::make_shared<OffsetCloud>();
+
+  decoder.batch_.push(1.0f, 1.0f, 1.0f, 10, 5.0, 0);
+  decoder.batch_.push(2.0f, 2.0f, 2.0f, 20, 5.5, 1);
+  decoder.flushBatch();
+  decoder.batch_.push(3.0f, 3.0f, 3.0f, 30, 5.75, 0);
+  decoder.splitFrame(2, 5.75);
+
+  OffsetCloud& cloud = *decoder.point_cloud_;
+  ASSERT_EQ(cloud.points.size(), 3);
+  ASSERT_EQ(cloud.points[0].ts_offset, 0.0f);
+  ASSERT_EQ(cloud.points[1].ts_offset, 0.5f);
+  ASSERT_EQ(cloud.points[2].ts_offset, 0.75f);
+
+  // the cloud is stamped with the first point, whatever ts_first_point is.
+  ASSERT_EQ(cloud_ts, 5.0);
+}
+
+TEST(TestDecoder, flushBatch_quantized)
+{
+  typedef PointCloudT<PointXYZIRQ16> Q16Cloud;
+
+  class MyQ16Decoder : public DecoderMech<Q16Cloud>
+  {
+  public:
+    MyQ16Decoder(const RSDecoderMechConstParam& const_param, const RSDecoderParam& param)
+      : DecoderMech<Q16Cloud>(const_param, param)
+    {
+    }
+
+    virtual void decodeDifopPkt(const uint8_t* packet, size_t size) {}
+    virtual bool decodeMsopPkt(const uint8_t* pkt, size_t size) { return false; }
+  };
+
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.dense_points = false;
+  MyQ16Decoder decoder(const_param, param);
+  decoder.regCallback(errCallback, nullptr);
+  decoder.point_cloud_ = std::make_shared<Q16Cloud>();
+
+  // not dense. the point out of range is marked invalid.
+  decoder.batch_.push(1.0f, 1.0f, 1.0f, 10, 5.0, 0);
+  decoder.batch_.push(200.0f, 1.0f, 1.0f, 20, 5.5, 1);
+  decoder.flushBatch();
+
+  Q16Cloud& cloud = *decoder.point_cloud_;
+  ASSERT_EQ(cloud.points.size(), 2);
+  ASSERT_EQ(cloud.points[0].x, 200);
+  ASSERT_EQ(cloud.points[1].x, -32768);
+  ASSERT_EQ(cloud.points[1].y, -32768);
+  ASSERT_EQ(cloud.points[1].z, -32768);
+
+  // dense. the point out of range is dropped.
+  param.dense_points = true;
+  MyQ16Decoder decoder2(const_param, param);
+  decoder2.regCallback(errCallback, nullptr);
+  decoder2.point_cloud_ = std::make_shared<Q16Cloud>();
+
+  decoder2.batch_.push(1.0f, 1.0f, 1.0f, 10, 5.0, 0);
+  decoder2.batch_.push(200.0f, 1.0f, 1.0f, 20, 5.5, 1);
+  decoder2.flushBatch();
+  ASSERT_EQ(decoder2.point_cloud_->points.size(), 1);
+  ASSERT_EQ(decoder2.point_cloud_->points[0].x, 200);
+}
+
+TEST(TestDecoder, flushBatch_deskew)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.ts_first_point = true;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  double cloud_ts = 0.0;
+  decoder.regCallback(errCallback, [&cloud_ts](uint16_t height, double ts) { cloud_ts = ts; });
+
+  // the LiDAR moves along x at 1 m/s
+  decoder.regPoseCallback([](double ts, RSPose& pose) -> bool
+      {
+        if (ts > 10.0)
+          return false;
+
+        pose = RSPose();
+        pose.x = ts;
+        return true;
+      });
+
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 1.0, 0);
+  decoder.batch_.pushNan(1.5, 1);
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 2.0, 0);
+  decoder.flushBatch();
+
+  PointCloud& cloud = *decoder.point_cloud_;
+  ASSERT_EQ(cloud.points.size(), 3);
+  ASSERT_NEAR(cloud.points[0].x, 5.0f, 1e-5);
+  ASSERT_TRUE(std::isnan(cloud.points[1].x));
+  ASSERT_NEAR(cloud.points[2].x, 6.0f, 1e-5);
+
+  // pose not available
+  errCode = ERRCODE_SUCCESS;
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 11.0, 0);
+  decoder.splitFrame(2, 11.0);
+  ASSERT_EQ(errCode, ERRCODE_NOPOSE);
+  ASSERT_EQ(cloud.points[3].x, 5.0f);
+  ASSERT_EQ(cloud_ts, 1.0);
+
+  // reported once per frame
+  errCode = ERRCODE_SUCCESS;
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 12.0, 0);
+  decoder.flushBatch();
+  ASSERT_EQ(errCode, ERRCODE_NOPOSE);
+
+  errCode = ERRCODE_SUCCESS;
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 13.0, 0);
+  decoder.flushBatch();
+  ASSERT_EQ(errCode, ERRCODE_SUCCESS);
+
+  decoder.splitFrame(2, 13.0);
+  errCode = ERRCODE_SUCCESS;
+  decoder.batch_.push(5.0f, 0.0f, 0.0f, 10, 14.0, 0);
+  decoder.flushBatch();
+  ASSERT_EQ(errCode, ERRCODE_NOPOSE);
+}
+
+TEST(TestDecoder, splitFrame_voxel)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.voxel_size = 1.0f;
+  MyDecoder decoder(const_param, param);
+  decoder.regCallback(errCallback, [](uint16_t height, double ts) {});
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  // instead of the full cloud
+  decoder.batch_.push(0.2f, 0.0f, 0.0f, 10, 1.0, 0);
+  decoder.batch_.push(0.4f, 0.0f, 0.0f, 20, 1.0, 1);
+  decoder.batch_.pushNan(1.0, 0);
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 0);
+
+  decoder.splitFrame(2, 1.0);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 1);
+  ASSERT_NEAR(decoder.point_cloud_->points[0].x, 0.3f, 1e-6);
+
+  // alongside the full cloud
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+  decoder.voxel_cloud_ = std::make_shared<PointCloud>();
+  decoder.batch_.push(0.2f, 0.0f, 0.0f, 10, 2.0, 0);
+  decoder.batch_.push(0.4f, 0.0f, 0.0f, 20, 2.0, 1);
+  decoder.splitFrame(2, 2.0);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.voxel_cloud_->points.size(), 1);
+}
+
+TEST(TestDecoder, flushBatch_roi)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.dense_points = true;
+  param.transform_param.x = 10.0f;
+
+  RSCropBox body; // in LiDAR frame
+  body.length = 2.0f;
+  body.width = 2.0f;
+  body.height = 2.0f;
+  body.include = false;
+  RSCropBox roi; // in transformed frame
+  roi.x = 10.0f;
+  roi.length = 10.0f;
+  roi.width = 10.0f;
+  roi.height = 10.0f;
+  roi.transformed = true;
+  param.crop_boxes = {body, roi};
+
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  decoder.batch_.push(0.5f, 0.0f, 0.0f, 10, 1.0, 0, 0.5f, 0);      // inside the body
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 0, 2.0f, 0);      // kept
+  decoder.batch_.push(8.0f, 0.0f, 0.0f, 30, 1.0, 0, 8.0f, 0);      // out of the roi after transform
+  decoder.flushBatch();
+
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 1);
+  ASSERT_EQ(decoder.point_cloud_->points[0].x, 12.0f);
+  ASSERT_EQ(decoder.point_cloud_->points[0].intensity, 20);
+}
+
+TEST(TestDecoder, flushBatch_dualReturn)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.dual_return_mode = DUAL_RETURN_STRONGEST;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f);
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 1, 1.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 0, 2.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 1, 2.0f);
+
+  // single return mode
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 4);
+
+  decoder.point_cloud_->points.clear();
+  decoder.echo_mode_ = ECHO_DUAL;
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f);
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 1, 1.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 0, 2.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 1, 2.0f);
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.point_cloud_->points[0].intensity, 20);
+}
+
+TEST(TestDecoder, flushBatch_splitEcho)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+  const_param.base.CHANNELS_PER_BLOCK = 2;
+  const_param.BLOCK_DURATION = 1.0 / 20; // 2 blocks per frame
+
+  RSDecoderParam param;
+  param.dual_return_mode = DUAL_RETURN_SPLIT;
+  param.organized = true;
+  MyDecoder decoder(const_param, param);
+  decoder.echo_mode_ = ECHO_DUAL;
+  ASSERT_EQ(decoder.getMaxPointsPerFrame(), 4);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+  decoder.echo_cloud_ = std::make_shared<PointCloud>();
+
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f);
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 1, 1.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 0, 2.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 1, 2.0f);
+  decoder.flushBatch();
+
+  ASSERT_EQ(decoder.batch_.size(), 0);
+  ASSERT_EQ(decoder.echo_batch_.size(), 0);
+  ASSERT_EQ(decoder.frame_pts_, 2);
+
+  // organized, 2 rings x 1 column. one return of the 2 blocks is in each cloud.
+  ASSERT_EQ(decoder.frame_width_, 1);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.echo_cloud_->points.size(), 2);
+  ASSERT_EQ(decoder.point_cloud_->points[0].x, 1.0f);
+  ASSERT_EQ(decoder.point_cloud_->points[1].x, 1.0f);
+  ASSERT_EQ(decoder.echo_cloud_->points[0].x, 2.0f);
+  ASSERT_EQ(decoder.echo_cloud_->points[1].x, 2.0f);
+}
+
+TEST(TestDecoder, flushBatch_organizedStrongest)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+  const_param.base.CHANNELS_PER_BLOCK = 2;
+  const_param.BLOCK_DURATION = 1.0 / 40; // 4 blocks per frame
+
+  RSDecoderParam param;
+  param.dual_return_mode = DUAL_RETURN_STRONGEST;
+  param.organized = true;
+  MyDecoder decoder(const_param, param);
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  // single return. every block is a column.
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f);
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.frame_width_, 4);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 8);
+
+  // dual return. the strongest of 2 blocks is a column.
+  decoder.point_cloud_->points.clear();
+  decoder.echo_mode_ = ECHO_DUAL;
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f);
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 1, 1.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 0, 2.0f);
+  decoder.batch_.push(2.0f, 0.0f, 0.0f, 20, 1.0, 1, 2.0f);
+  decoder.flushBatch();
+  ASSERT_EQ(decoder.frame_width_, 2);
+  ASSERT_EQ(decoder.point_cloud_->points.size(), 4);
+  ASSERT_EQ(decoder.point_cloud_->points[0].x, 2.0f); // [0][0]
+  ASSERT_TRUE(std::isnan(decoder.point_cloud_->points[1].x)); // [0][1]
+  ASSERT_EQ(decoder.point_cloud_->points[2].x, 2.0f); // [1][0]
+}
+
+TEST(TestDecoder, splitFrame_sector)
+{
+  RSDecoderMechConstParam const_param = {};
+  const_param.base.LASER_NUM = 2;
+
+  RSDecoderParam param;
+  param.sector_angle = 90.0f;
+  MyDecoder decoder(const_param, param);
+  decoder.regCallback(errCallback, [](uint16_t height, double ts) {});
+  decoder.point_cloud_ = std::make_shared<PointCloud>();
+
+  std::vector<std::pair<size_t, size_t>> ranges;
+  std::vector<SectorInfo> infos;
+  decoder.regSectorCallback([&](size_t from, size_t to, double ts, const SectorInfo& info) 
+      {
+        ranges.emplace_back(from, to);
+        infos.push_back(info);
+      });
+
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.0, 0, 1.0f, 0);
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.1, 1, 1.0f, 5000);
+  decoder.flushBatch();
+  ASSERT_EQ(infos.size(), 0);
+
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.2, 0, 1.0f, 9000);
+  decoder.batch_.pushNan(1.3, 1);
+  decoder.flushBatch();
+  ASSERT_EQ(infos.size(), 1);
+  ASSERT_EQ(ranges[0], std::make_pair((size_t)0, (size_t)4));
+  ASSERT_EQ(infos[0].index, 0);
+  ASSERT_FALSE(infos[0].last);
+  ASSERT_EQ(infos[0].start_angle, 0.0f);
+  ASSERT_EQ(infos[0].end_angle, 90.0f);
+  ASSERT_EQ(infos[0].start_ts, 1.0);
+  ASSERT_EQ(infos[0].end_ts, 1.3);
+
+  // the rest of the frame
+  decoder.batch_.push(1.0f, 0.0f, 0.0f, 10, 1.4, 0, 1.0f, 10000);
+  decoder.splitFrame(2, 1.4);
+  ASSERT_EQ(infos.size(), 2);
+  ASSERT_EQ(ranges[1], std::make_pair((size_t)4, (size_t)5));
+  ASSERT_EQ(infos[1].index, 1);
+  ASSERT_TRUE(infos[1].last);
+
+  // not for organized point cloud
+  param.organized = true;
+  MyDecoder decoder2(const_param, param);
+  ASSERT_EQ(decoder2.param_.sector_angle, 0.0f);
+}
@@ -0,0 +1,65 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/deskew.hpp>
+
+using namespace robosense::lidar;
+
+static RSPose makePose(double x, double yaw)
+{
+  RSPose pose;
+  pose.x = x;
+  pose.qz = std::sin(yaw / 2);
+  pose.qw = std::cos(yaw / 2);
+  return pose;
+}
+
+TEST(TestPoseBuffer, interpolate)
+{
+  PoseBuffer buffer(2);
+  RSPose pose;
+  ASSERT_FALSE(buffer.interpolate(0.0, pose));
+
+  buffer.push(0.0, makePose(0.0, 0.0));
+  buffer.push(1.0, makePose(1.0, 0.0));
+  buffer.push(2.0, makePose(3.0, M_PI / 2));
+  ASSERT_EQ(buffer.poses_.size(), 2);
+
+  // out of range
+  ASSERT_FALSE(buffer.interpolate(0.5, pose));
+  ASSERT_FALSE(buffer.interpolate(2.5, pose));
+
+  ASSERT_TRUE(buffer.interpolate(1.0, pose));
+  ASSERT_DOUBLE_EQ(pose.x, 1.0);
+
+  ASSERT_TRUE(buffer.interpolate(1.5, pose));
+  ASSERT_DOUBLE_EQ(pose.x, 2.0);
+  ASSERT_NEAR(pose.qz, std::sin(M_PI / 8), 1e-9);
+  ASSERT_NEAR(pose.qw, std::cos(M_PI / 8), 1e-9);
+}
+
+TEST(TestDeskew, apply)
+{
+  Deskew deskew;
+  deskew.setReference(makePose(1.0, 0.0));
+
+  // the LiDAR moves 1m forward along x within [0, 1]
+  float xs[] = {10.0f, 10.0f, 10.0f};
+  float ys[] = {0.0f, 0.0f, 0.0f};
+  float zs[] = {1.0f, 1.0f, 1.0f};
+  double tss[] = {0.0, 0.5, 1.0};
+  deskew.apply(xs, ys, zs, tss, 3, 0.0, makePose(1.0, 0.0), 1.0, makePose(2.0, 0.0));
+
+  ASSERT_NEAR(xs[0], 10.0f, 1e-5);
+  ASSERT_NEAR(xs[1], 10.5f, 1e-5);
+  ASSERT_NEAR(xs[2], 11.0f, 1e-5);
+  ASSERT_NEAR(zs[2], 1.0f, 1e-5);
+
+  // rotated by 90 degree to the reference
+  float x = 1.0f, y = 0.0f, z = 0.0f;
+  double ts = 0.0;
+  deskew.setReference(makePose(0.0, 0.0));
+  deskew.apply(&x, &y, &z, &ts, 1, 0.0, makePose(0.0, M_PI / 2), 0.0, makePose(0.0, M_PI / 2));
+  ASSERT_NEAR(x, 0.0f, 1e-5);
+  ASSERT_NEAR(y, 1.0f, 1e-5);
+}
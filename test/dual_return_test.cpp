@@ -0,0 +1,109 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/dual_return.hpp>
+
+using namespace robosense::lidar;
+
+static void pushFiring(PointBatch& batch, double ts, float dist_a, uint8_t int_a, float dist_b, uint8_t int_b)
+{
+  // two lasers, two returns
+  batch.push(dist_a, 0.0f, 0.0f, int_a, ts, 0, dist_a);
+  batch.push(dist_a, 1.0f, 0.0f, int_a, ts, 1, dist_a);
+  batch.push(dist_b, 0.0f, 0.0f, int_b, ts, 0, dist_b);
+  batch.push(dist_b, 1.0f, 0.0f, int_b, ts, 1, dist_b);
+}
+
+TEST(TestDualReturnFilter, select)
+{
+  PointBatch batch;
+  pushFiring(batch, 1.0, 10.0f, 20, 20.0f, 10);
+  batch.push(5.0f, 0.0f, 0.0f, 5, 2.0, 0, 5.0f); // no partner
+  batch.push(5.0f, 1.0f, 0.0f, 5, 2.0, 1, 5.0f);
+  pushFiring(batch, 3.0, 0.0f, 0, 30.0f, 10); // first return invalid
+
+  {
+    PointBatch b = batch;
+    DualReturnFilter filter(DUAL_RETURN_STRONGEST, 0.0f);
+    filter.setStride(2);
+    filter.apply(b);
+    ASSERT_EQ(b.size(), 6);
+    ASSERT_EQ(b.xs_[0], 10.0f);
+    ASSERT_EQ(b.ys_[1], 1.0f);
+    ASSERT_EQ(b.xs_[2], 5.0f);
+    ASSERT_EQ(b.xs_[4], 30.0f);
+  }
+
+  {
+    PointBatch b = batch;
+    DualReturnFilter filter(DUAL_RETURN_LAST, 0.0f);
+    filter.setStride(2);
+    filter.apply(b);
+    ASSERT_EQ(b.size(), 6);
+    ASSERT_EQ(b.xs_[0], 20.0f);
+    ASSERT_EQ(b.xs_[4], 30.0f);
+  }
+
+  {
+    PointBatch b = batch;
+    DualReturnFilter filter(DUAL_RETURN_FIRST, 0.0f);
+    filter.setStride(2);
+    filter.apply(b);
+    ASSERT_EQ(b.size(), 6);
+    ASSERT_EQ(b.xs_[0], 10.0f);
+    ASSERT_EQ(b.xs_[4], 30.0f);
+  }
+}
+
+TEST(TestDualReturnFilter, dedupe)
+{
+  PointBatch batch;
+  pushFiring(batch, 1.0, 10.0f, 20, 10.01f, 10);
+  pushFiring(batch, 2.0, 10.0f, 20, 12.0f, 10);
+
+  DualReturnFilter filter(DUAL_RETURN_DEDUPE, 0.02f);
+  filter.setStride(2);
+  filter.apply(batch);
+  ASSERT_EQ(batch.size(), 8);
+  ASSERT_EQ(batch.xs_[0], 10.0f);
+  ASSERT_TRUE(std::isnan(batch.xs_[2]));
+  ASSERT_EQ(batch.distances_[3], 0.0f);
+  ASSERT_EQ(batch.timestamps_[3], 1.0);
+  ASSERT_EQ(batch.xs_[6], 12.0f);
+}
+
+TEST(TestDualReturnFilter, disabled)
+{
+  DualReturnFilter filter(DUAL_RETURN_STRONGEST, 0.0f);
+  ASSERT_FALSE(filter.enabled()); // no stride
+
+  DualReturnFilter all(DUAL_RETURN_ALL, 0.0f);
+  all.setStride(2);
+  ASSERT_FALSE(all.enabled());
+}
+
+TEST(TestDualReturnFilter, split)
+{
+  PointBatch batch;
+  pushFiring(batch, 1.0, 10.0f, 20, 20.0f, 10);
+  batch.push(5.0f, 0.0f, 0.0f, 5, 2.0, 0, 5.0f); // no partner
+  batch.push(5.0f, 1.0f, 0.0f, 5, 2.0, 1, 5.0f);
+
+  DualReturnFilter filter(DUAL_RETURN_SPLIT, 0.0f);
+  filter.setStride(2);
+  ASSERT_TRUE(filter.splitting());
+
+  PointBatch echo;
+  filter.split(batch, echo);
+  ASSERT_EQ(batch.size(), 4);
+  ASSERT_EQ(echo.size(), 4);
+
+  ASSERT_EQ(batch.xs_[0], 10.0f);
+  ASSERT_EQ(batch.xs_[2], 5.0f);
+  ASSERT_EQ(echo.xs_[0], 20.0f);
+  ASSERT_EQ(echo.ys_[1], 1.0f);
+  ASSERT_EQ(echo.rings_[1], 1);
+  ASSERT_TRUE(std::isnan(echo.xs_[2])); // aligned with the point without partner
+  ASSERT_EQ(echo.timestamps_[3], 2.0);
+  ASSERT_EQ(echo.rings_[3], 1);
+}
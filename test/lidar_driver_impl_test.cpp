@@ -0,0 +1,121 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/lidar_driver_impl.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+
+#include <thread>
+
+using namespace robosense::lidar;
+
+typedef PointXYZI PointT;
+typedef PointCloudT<PointT> PointCloud;
+
+static void addPoint(PointCloud& cloud)
+{
+  PointT point;
+  point.x = point.y = point.z = 1.0f;
+  point.intensity = 1;
+  cloud.points.emplace_back(point);
+}
+
+TEST(TestLidarDriverImpl, splitFrame_seqAfterHandoff)
+{
+  std::vector<std::shared_ptr<PointCloud>> clouds;
+  std::vector<std::shared_ptr<PointCloud>> echo_clouds;
+
+  LidarDriverImpl<PointCloud> driver;
+  driver.regPointCloudCallback(
+      []() { return std::make_shared<PointCloud>(); },
+      [&clouds](std::shared_ptr<PointCloud> cloud) 
+      { 
+        clouds.push_back(cloud); 
+        cloud->seq = 100; // the consumer may change it at once
+      });
+  driver.regSecondEchoPointCloudCallback(
+      []() { return std::make_shared<PointCloud>(); },
+      [&echo_clouds](std::shared_ptr<PointCloud> cloud) { echo_clouds.push_back(cloud); });
+
+  RSDriverParam param;
+  param.input_type = InputType::RAW_PACKET;
+  param.lidar_type = LidarType::RS16;
+  param.decoder_param.dual_return_mode = DUAL_RETURN_SPLIT;
+  ASSERT_TRUE(driver.init(param));
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    addPoint(*driver.decoder_ptr_->point_cloud_);
+    addPoint(*driver.decoder_ptr_->echo_cloud_);
+    driver.splitFrame(1, 1.0 + i);
+
+    ASSERT_EQ(echo_clouds.size(), i + 1);
+    ASSERT_EQ(echo_clouds[i]->seq, i);
+  }
+}
+
+TEST(TestLidarDriverImpl, splitFrame_dsSeqAfterHandoff)
+{
+  std::vector<std::shared_ptr<PointCloud>> ds_clouds;
+
+  LidarDriverImpl<PointCloud> driver;
+  driver.regPointCloudCallback(
+      []() { return std::make_shared<PointCloud>(); },
+      [](std::shared_ptr<PointCloud> cloud) { cloud->seq = 100; });
+  driver.regDownsampledPointCloudCallback(
+      []() { return std::make_shared<PointCloud>(); },
+      [&ds_clouds](std::shared_ptr<PointCloud> cloud) { ds_clouds.push_back(cloud); });
+
+  RSDriverParam param;
+  param.input_type = InputType::RAW_PACKET;
+  param.lidar_type = LidarType::RS16;
+  param.decoder_param.voxel_size = 0.1f;
+  ASSERT_TRUE(driver.init(param));
+
+  for (uint32_t i = 0; i < 2; i++)
+  {
+    addPoint(*driver.decoder_ptr_->point_cloud_);
+    addPoint(*driver.decoder_ptr_->voxel_cloud_);
+    driver.splitFrame(1, 1.0 + i);
+
+    ASSERT_EQ(ds_clouds.size(), i + 1);
+    ASSERT_EQ(ds_clouds[i]->seq, i);
+  }
+}
+
+TEST(TestLidarDriverImpl, init_noCloud)
+{
+  size_t gets = 0;
+  std::vector<ErrCode> errs;
+
+  LidarDriverImpl<PointCloud> driver;
+  driver.regPointCloudCallback(
+      [&gets]() { return (gets++ == 0) ? nullptr : std::make_shared<PointCloud>(); },
+      [](std::shared_ptr<PointCloud> cloud) {});
+  driver.regExceptionCallback([&errs](const Error& err) { errs.push_back(err.error_code); });
+
+  RSDriverParam param;
+  param.input_type = InputType::RAW_PACKET;
+  param.lidar_type = LidarType::RS16;
+  param.decoder_param.wait_for_difop = false;
+
+  // no cloud at init(), but it still succeeds
+  ASSERT_TRUE(driver.init(param));
+  ASSERT_FALSE(driver.clouds_ready_);
+  ASSERT_EQ(errs.size(), 1);
+  ASSERT_EQ(errs[0], ERRCODE_POINTCLOUDNULL);
+
+  // gotten again with the first MSOP packet
+  Packet pkt;
+  pkt.buf_.resize(1248, 0);
+  const uint8_t msop_id[] = {0x55, 0xAA, 0x05, 0x0A, 0x5A, 0xA5, 0x50, 0xA0};
+  memcpy(pkt.buf_.data(), msop_id, sizeof(msop_id));
+
+  ASSERT_TRUE(driver.start());
+  driver.decodePacket(pkt);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  driver.stop();
+
+  ASSERT_TRUE(driver.clouds_ready_);
+  ASSERT_TRUE(driver.decoder_ptr_->point_cloud_ != nullptr);
+  ASSERT_EQ(gets, 2);
+}
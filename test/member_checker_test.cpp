@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/member_checker.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+#include <rs_driver/msg/soa_point_cloud_msg.hpp>
+
+#include <cmath>
+
+typedef PointCloudT<PointXYZIRT> PointCloud;
+
+struct PointCloudXYZ
+{
+  std::vector<float> xs;
+  std::vector<float> ys;
+  std::vector<float> zs;
+
+  size_t size() const
+  {
+    return xs.size();
+  }
+
+  void clear()
+  {
+    xs.clear();
+    ys.clear();
+    zs.clear();
+  }
+};
+
+TEST(TestMemberChecker, addPoint)
+{
+  PointCloud cloud;
+  addPoint(cloud, 1.0f, 2.0f, 3.0f, 4, 5.0, 6);
+  addPoint(cloud, NAN, NAN, NAN, 0, 7.0, 8);
+  ASSERT_EQ(pointNum(cloud), 2);
+
+  ASSERT_EQ(cloud.points[0].x, 1.0f);
+  ASSERT_EQ(cloud.points[0].y, 2.0f);
+  ASSERT_EQ(cloud.points[0].z, 3.0f);
+  ASSERT_EQ(cloud.points[0].intensity, 4);
+  ASSERT_EQ(cloud.points[0].timestamp, 5.0);
+  ASSERT_EQ(cloud.points[0].ring, 6);
+  ASSERT_TRUE(std::isnan(cloud.points[1].x));
+
+  clearPoints(cloud);
+  ASSERT_EQ(pointNum(cloud), 0);
+
+  reservePoints(cloud, 100);
+  ASSERT_GE(cloud.points.capacity(), 100);
+}
+
+TEST(TestMemberChecker, addPoint_SoA)
+{
+  PointCloudSoA cloud;
+  addPoint(cloud, 1.0f, 2.0f, 3.0f, 4, 5.0, 6);
+  addPoint(cloud, NAN, NAN, NAN, 0, 7.0, 8);
+  ASSERT_EQ(pointNum(cloud), 2);
+
+  ASSERT_EQ(cloud.xs[0], 1.0f);
+  ASSERT_EQ(cloud.ys[0], 2.0f);
+  ASSERT_EQ(cloud.zs[0], 3.0f);
+  ASSERT_EQ(cloud.intensities[0], 4);
+  ASSERT_EQ(cloud.timestamps[0], 5.0);
+  ASSERT_EQ(cloud.rings[0], 6);
+  ASSERT_TRUE(std::isnan(cloud.xs[1]));
+  ASSERT_EQ(cloud.rings[1], 8);
+
+  clearPoints(cloud);
+  ASSERT_EQ(pointNum(cloud), 0);
+  ASSERT_EQ(cloud.rings.size(), 0);
+
+  reservePoints(cloud, 100);
+  ASSERT_GE(cloud.xs.capacity(), 100);
+  ASSERT_GE(cloud.timestamps.capacity(), 100);
+}
+
+TEST(TestMemberChecker, addPoint_SoA_partial)
+{
+  PointCloudXYZ cloud;
+  addPoint(cloud, 1.0f, 2.0f, 3.0f, 4, 5.0, 6);
+  ASSERT_EQ(pointNum(cloud), 1);
+  ASSERT_EQ(cloud.zs[0], 3.0f);
+}
+
+TEST(TestMemberChecker, setPointAt)
+{
+  PointCloud cloud;
+  resizePoints(cloud, 2);
+  setPointAt(cloud, 1, 1.0f, 2.0f, 3.0f, 4, 5.0, 6);
+  ASSERT_EQ(pointNum(cloud), 2);
+  ASSERT_EQ(cloud.points[1].z, 3.0f);
+  ASSERT_EQ(cloud.points[1].ring, 6);
+
+  PointCloudSoA soa;
+  resizePoints(soa, 2);
+  setPointAt(soa, 1, 1.0f, 2.0f, 3.0f, 4, 5.0, 6);
+  ASSERT_EQ(pointNum(soa), 2);
+  ASSERT_EQ(soa.zs[1], 3.0f);
+  ASSERT_EQ(soa.rings[1], 6);
+}
+
+TEST(TestMemberChecker, addPoint_quantized)
+{
+  ASSERT_EQ(sizeof(PointXYZIRQ16), 8);
+
+  PointCloudT<PointXYZIRQ16> cloud;
+  addPoint(cloud, 1.0f, -2.0024f, 0.0026f, 4, 5.0, 6);
+  addPoint(cloud, NAN, 2.0f, 3.0f, 0, 7.0, 8);
+  addPoint(cloud, 1.0f, 200.0f, 3.0f, 0, 7.0, 8);
+  addPoint(cloud, 163.8f, -163.8f, 0.0f, 0, 7.0, 8);
+  ASSERT_EQ(pointNum(cloud), 4);
+
+  ASSERT_EQ(cloud.points[0].x, 200);
+  ASSERT_EQ(cloud.points[0].y, -400);
+  ASSERT_EQ(cloud.points[0].z, 1);
+  ASSERT_EQ(cloud.points[0].intensity, 4);
+  ASSERT_EQ(cloud.points[0].ring, 6);
+
+  // NAN, and out of range, are invalid as a whole
+  for (size_t i = 1; i <= 2; i++)
+  {
+    ASSERT_EQ(cloud.points[i].x, -32768);
+    ASSERT_EQ(cloud.points[i].y, -32768);
+    ASSERT_EQ(cloud.points[i].z, -32768);
+  }
+
+  // the limits, except the minimum
+  ASSERT_EQ(cloud.points[3].x, 32760);
+  ASSERT_EQ(cloud.points[3].y, -32760);
+
+  ASSERT_TRUE(isValidPoint<PointCloudT<PointXYZIRQ16>>(163.8f, -163.83f, 0.0f));
+  ASSERT_FALSE(isValidPoint<PointCloudT<PointXYZIRQ16>>(163.84f, 0.0f, 0.0f));
+  ASSERT_FALSE(isValidPoint<PointCloudT<PointXYZIRQ16>>(0.0f, -163.84f, 0.0f));
+  ASSERT_FALSE(isValidPoint<PointCloudT<PointXYZIRQ16>>(NAN, 0.0f, 0.0f));
+  ASSERT_TRUE(isValidPoint<PointCloudT<PointXYZIRT>>(200.0f, 0.0f, 0.0f));
+  ASSERT_FALSE(isValidPoint<PointCloudT<PointXYZIRT>>(NAN, 0.0f, 0.0f));
+
+  PointCloudT<PointXYZIRQ32> cloud32;
+  addPoint(cloud32, 200.0f, -0.0014f, 0.0f, 4, 5.0, 6);
+  ASSERT_EQ(cloud32.points[0].x, 200000);
+  ASSERT_EQ(cloud32.points[0].y, -1);
+  ASSERT_EQ(cloud32.points[0].z, 0);
+}
+
+TEST(TestMemberChecker, addPoint_tsOffset)
+{
+  ASSERT_TRUE(RS_POINT_HAS_MEMBER(PointCloudT<PointXYZIRTOffset>, ts_offset));
+  ASSERT_FALSE(RS_POINT_HAS_MEMBER(PointCloudT<PointXYZIRT>, ts_offset));
+  ASSERT_FALSE(RS_POINT_HAS_MEMBER(PointCloudSoA, ts_offset));
+
+  PointCloudT<PointXYZIRTOffset> cloud;
+  addPoint(cloud, 1.0f, 2.0f, 3.0f, 4, 100.25, 6, 100.0);
+  ASSERT_EQ(cloud.points[0].ts_offset, 0.25f);
+  ASSERT_EQ(cloud.points[0].ring, 6);
+
+  PointCloudT<PointXYZIRTOffsetNs> cloud_ns;
+  addPoint(cloud_ns, 1.0f, 2.0f, 3.0f, 4, 100.000123, 6, 100.0);
+  addPoint(cloud_ns, 1.0f, 2.0f, 3.0f, 4, 99.0, 6, 100.0);
+  ASSERT_NEAR(cloud_ns.points[0].ts_offset_ns, 123000, 1);
+  ASSERT_EQ(cloud_ns.points[1].ts_offset_ns, 0);
+}
+
+TEST(TestMemberChecker, appendPoints)
+{
+  PointCloud cloud;
+  addPoint(cloud, 1.0f, 1.0f, 1.0f, 1, 1.0, 1);
+  addPoint(cloud, 2.0f, 2.0f, 2.0f, 2, 2.0, 2);
+  addPoint(cloud, 3.0f, 3.0f, 3.0f, 3, 3.0, 3);
+
+  PointCloud sector;
+  appendPoints(sector, cloud, 1, 3);
+  ASSERT_EQ(pointNum(sector), 2);
+  ASSERT_EQ(sector.points[0].x, 2.0f);
+  ASSERT_EQ(sector.points[1].ring, 3);
+
+  PointCloudSoA soa;
+  addPoint(soa, 1.0f, 1.0f, 1.0f, 1, 1.0, 1);
+  addPoint(soa, 2.0f, 2.0f, 2.0f, 2, 2.0, 2);
+
+  PointCloudSoA soa_sector;
+  appendPoints(soa_sector, soa, 1, 2);
+  ASSERT_EQ(pointNum(soa_sector), 1);
+  ASSERT_EQ(soa_sector.xs[0], 2.0f);
+  ASSERT_EQ(soa_sector.timestamps[0], 2.0);
+  ASSERT_EQ(soa_sector.rings[0], 2);
+}
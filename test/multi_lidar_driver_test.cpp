@@ -0,0 +1,308 @@
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include <rs_driver/api/multi_lidar_driver.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+#include <rs_driver/driver/decoder/decoder_RS16.hpp>
+
+using namespace robosense::lidar;
+
+typedef PointXYZI PointT;
+typedef MultiLidarDriver<PointT> Driver;
+typedef Driver::FusedPointCloud FusedPointCloud;
+
+class TestMultiLidarDriver : public ::testing::Test
+{
+protected:
+
+  void SetUp() override
+  {
+    driver_.regPointCloudCallback(
+        [this]() { return std::make_shared<FusedPointCloud>(); },
+        [this](std::shared_ptr<FusedPointCloud> cloud) { clouds_.push_back(cloud); });
+    driver_.regExceptionCallback(
+        [this](size_t src, const Error& err) { errors_.push_back(std::make_pair(src, err.error_code)); });
+
+    // two lidars, with slots of 10 and 20 points
+    driver_.sources_.resize(2);
+    for (size_t i = 0; i < 2; i++)
+    {
+      Driver::Source& s = driver_.sources_[i];
+      s.driver = std::make_shared<LidarDriverImpl<Driver::SlicePointCloud>>();
+      s.offset = i * 10;
+      s.capacity = (i + 1) * 10;
+      s.scratch.resize(s.capacity);
+      s.clouds[0] = std::make_shared<Driver::SlicePointCloud>();
+      s.clouds[1] = std::make_shared<Driver::SlicePointCloud>();
+      s.windows[0] = -1;
+      s.windows[1] = -1;
+      s.next = 1;
+      s.absent = false;
+
+      // the cloud of the first frame
+      driver_.getCloud(i);
+    }
+    driver_.total_points_ = 30;
+    driver_.period_ = 0.1;
+  }
+
+  // the lidar splits a frame of num points, as LidarDriverImpl does.
+  void splitFrame(size_t src, double ts, size_t num)
+  {
+    Driver::Source& s = driver_.sources_[src];
+    std::shared_ptr<Driver::SlicePointCloud> cloud = s.clouds[s.next];
+    for (size_t i = 0; i < num; i++)
+    {
+      PointT point;
+      point.x = (float)src;
+      point.y = point.z = 0.0f;
+      point.intensity = 0;
+      cloud->points.emplace_back(point);
+    }
+    cloud->timestamp = ts;
+
+    driver_.getCloud(src);
+    driver_.putCloud(src, cloud);
+  }
+
+  bool hasError(size_t src, ErrCode code)
+  {
+    return std::find(errors_.begin(), errors_.end(), std::make_pair(src, code)) != errors_.end();
+  }
+
+  Driver driver_;
+  std::vector<std::shared_ptr<FusedPointCloud>> clouds_;
+  std::vector<std::pair<size_t, ErrCode>> errors_;
+};
+
+TEST_F(TestMultiLidarDriver, fuse)
+{
+  // first frames are partial. they are discarded.
+  splitFrame(0, 0.05, 3);
+  splitFrame(1, 0.06, 3);
+  ASSERT_EQ(clouds_.size(), 0u);
+
+  splitFrame(0, 0.15, 3);
+  ASSERT_EQ(clouds_.size(), 0u);
+  splitFrame(1, 0.16, 5);
+  ASSERT_EQ(clouds_.size(), 1u);
+
+  const FusedPointCloud& cloud = *clouds_[0];
+  ASSERT_EQ(cloud.points.size(), 30u);
+  ASSERT_EQ(cloud.width, 30u);
+  ASSERT_DOUBLE_EQ(cloud.timestamp, 0.1);
+  ASSERT_EQ(cloud.seq, 0u);
+  ASSERT_FALSE(cloud.is_dense);
+
+  ASSERT_EQ(cloud.sources.size(), 2u);
+  ASSERT_EQ(cloud.sources[0].offset, 0u);
+  ASSERT_EQ(cloud.sources[0].size, 3u);
+  ASSERT_TRUE(cloud.sources[0].received);
+  ASSERT_DOUBLE_EQ(cloud.sources[0].timestamp, 0.15);
+  ASSERT_EQ(cloud.sources[1].offset, 10u);
+  ASSERT_EQ(cloud.sources[1].size, 5u);
+  ASSERT_TRUE(cloud.sources[1].received);
+
+  // points are in the slots of their lidars, and the rest are NAN
+  ASSERT_EQ(cloud.points[2].x, 0.0f);
+  ASSERT_TRUE(std::isnan(cloud.points[3].x));
+  ASSERT_EQ(cloud.points[14].x, 1.0f);
+  ASSERT_TRUE(std::isnan(cloud.points[15].x));
+  ASSERT_TRUE(std::isnan(cloud.points[29].x));
+}
+
+TEST_F(TestMultiLidarDriver, inOrder)
+{
+  splitFrame(0, 0.05, 1);
+  splitFrame(1, 0.05, 1);
+
+  // lidar 0 is ahead of lidar 1
+  splitFrame(0, 0.15, 1);
+  splitFrame(0, 0.25, 2);
+  splitFrame(0, 0.35, 3);
+  ASSERT_EQ(clouds_.size(), 0u);
+
+  splitFrame(1, 0.15, 4);
+  splitFrame(1, 0.25, 5);
+  ASSERT_EQ(clouds_.size(), 2u);
+  ASSERT_DOUBLE_EQ(clouds_[0]->timestamp, 0.1);
+  ASSERT_EQ(clouds_[0]->sources[0].size, 1u);
+  ASSERT_EQ(clouds_[0]->sources[1].size, 4u);
+  ASSERT_DOUBLE_EQ(clouds_[1]->timestamp, 0.2);
+  ASSERT_EQ(clouds_[1]->sources[0].size, 2u);
+  ASSERT_EQ(clouds_[1]->sources[1].size, 5u);
+  ASSERT_EQ(clouds_[1]->seq, 1u);
+}
+
+TEST_F(TestMultiLidarDriver, missedWindow)
+{
+  splitFrame(0, 0.05, 1);
+  splitFrame(1, 0.05, 1);
+
+  // the frame of lidar 1 is not in the expected time window. it is discarded.
+  splitFrame(0, 0.15, 1);
+  splitFrame(1, 0.25, 2);
+  ASSERT_EQ(clouds_.size(), 1u);
+  ASSERT_TRUE(clouds_[0]->sources[0].received);
+  ASSERT_FALSE(clouds_[0]->sources[1].received);
+  ASSERT_EQ(clouds_[0]->sources[1].size, 0u);
+  ASSERT_TRUE(std::isnan(clouds_[0]->points[10].x));
+}
+
+TEST_F(TestMultiLidarDriver, absent)
+{
+  splitFrame(0, 0.05, 1);
+  splitFrame(1, 0.05, 1);
+  splitFrame(0, 0.15, 1);
+  ASSERT_EQ(clouds_.size(), 0u);
+
+  // lidar 1 stops. don't wait for it.
+  driver_.runExceptionCallback(1, Error(ERRCODE_MSOPTIMEOUT));
+  ASSERT_EQ(clouds_.size(), 1u);
+  ASSERT_FALSE(clouds_[0]->sources[1].received);
+
+  splitFrame(0, 0.25, 1);
+  ASSERT_EQ(clouds_.size(), 2u);
+
+  // lidar 1 is back
+  splitFrame(1, 0.28, 1);
+  splitFrame(0, 0.35, 1);
+  ASSERT_EQ(clouds_.size(), 2u);
+  splitFrame(1, 0.38, 2);
+  ASSERT_EQ(clouds_.size(), 3u);
+  ASSERT_EQ(clouds_[2]->sources[1].size, 2u);
+}
+
+TEST_F(TestMultiLidarDriver, skew)
+{
+  // lidar 1 is 6 time windows behind lidar 0.
+  splitFrame(0, 0.65, 1);
+  splitFrame(1, 0.05, 1);
+
+  for (int i = 1; i < 12; i++)
+  {
+    splitFrame(0, (i + 6) * 0.1 + 0.05, 2);
+    splitFrame(1, i * 0.1 + 0.05, 3);
+  }
+
+  // time windows don't wait for lidar 1 for ever, and lidar 0 goes on.
+  ASSERT_TRUE(hasError(1, ERRCODE_LIDARSKEW));
+  ASSERT_GT(clouds_.size(), 6u);
+  ASSERT_TRUE(clouds_.back()->sources[0].received);
+  ASSERT_DOUBLE_EQ(clouds_.back()->timestamp, 1.7);
+  for (size_t i = 1; i < clouds_.size(); i++)
+  {
+    ASSERT_GT(clouds_[i]->timestamp, clouds_[i - 1]->timestamp);
+  }
+}
+
+TEST_F(TestMultiLidarDriver, overflow)
+{
+  splitFrame(0, 0.05, 1);
+  splitFrame(1, 0.05, 1);
+
+  // the slot of lidar 0 is 10 points
+  splitFrame(0, 0.15, 15);
+  splitFrame(1, 0.15, 1);
+  ASSERT_EQ(clouds_.size(), 1u);
+  ASSERT_EQ(clouds_[0]->sources[0].size, 10u);
+  ASSERT_TRUE(hasError(0, ERRCODE_CLOUDOVERFLOW));
+}
+
+TEST_F(TestMultiLidarDriver, callbackOutOfLock)
+{
+  bool locked = false;
+  driver_.regPointCloudCallback(
+      [this, &locked]() 
+      {
+        locked = locked || !driver_.mtx_.try_lock() || (driver_.mtx_.unlock(), false);
+        return std::make_shared<FusedPointCloud>();
+      },
+      [this, &locked](std::shared_ptr<FusedPointCloud> cloud) 
+      {
+        locked = locked || !driver_.mtx_.try_lock() || (driver_.mtx_.unlock(), false);
+        clouds_.push_back(cloud);
+      });
+
+  splitFrame(0, 0.05, 1);
+  splitFrame(1, 0.05, 1);
+  splitFrame(0, 0.15, 1);
+  splitFrame(1, 0.15, 1);
+  ASSERT_EQ(clouds_.size(), 1u);
+  ASSERT_FALSE(locked);
+}
+
+static void buildRS16MsopPkt(RS16MsopPkt& pkt, uint64_t ts, uint16_t az)
+{
+  memset(&pkt, 0, sizeof(pkt));
+
+  uint8_t id[] = {0x55, 0xAA, 0x05, 0x0A, 0x5A, 0xA5, 0x50, 0xA0};
+  memcpy(pkt.header.id, id, sizeof(id));
+  createTimeYMD(ts, &pkt.header.timestamp);
+
+  for (uint16_t blk = 0; blk < 12; blk++)
+  {
+    RS16MsopBlock& block = pkt.blocks[blk];
+    block.id[0] = 0xFF;
+    block.id[1] = 0xEE;
+    block.azimuth = htons((uint16_t)((az + blk * 40) % 36000));
+
+    for (uint16_t chan = 0; chan < 32; chan++)
+    {
+      block.channels[chan].distance = htons(200); // 1m
+      block.channels[chan].intensity = 10;
+    }
+  }
+}
+
+TEST(TestMultiLidarDriverDecode, framesPastBoundary)
+{
+  std::vector<std::shared_ptr<FusedPointCloud>> clouds;
+
+  Driver driver;
+  driver.regPointCloudCallback(
+      []() { return std::make_shared<FusedPointCloud>(); },
+      [&clouds](std::shared_ptr<FusedPointCloud> cloud) { clouds.push_back(cloud); });
+
+  RSDriverParam param;
+  param.input_type = InputType::RAW_PACKET;
+  param.lidar_type = LidarType::RS16;
+  param.decoder_param.wait_for_difop = false;
+  param.decoder_param.use_lidar_clock = true;
+  param.decoder_param.dense_points = true;
+  ASSERT_TRUE(driver.init({param, param}, 0.1));
+
+  //
+  // packets of 12 blocks, about 1332 us long. the last block of a frame is often within 
+  // the firing time of its channels before the boundary, so its last point is past the boundary.
+  //
+  const uint64_t start = 1633021323000000;
+  const uint64_t pkt_us = 1332;
+  for (uint64_t i = 0; i < 600; i++)
+  {
+    for (size_t src = 0; src < 2; src++)
+    {
+      RS16MsopPkt pkt;
+      buildRS16MsopPkt(pkt, start + i * pkt_us + src * 500, (uint16_t)(i * 480));
+      driver.sources_[src].driver->decoder_ptr_->processMsopPkt((const uint8_t*)&pkt, sizeof(pkt));
+    }
+  }
+
+  //
+  // 0.8 s of packets. the first frame is partial and has no timestamp, so the time window of the frame
+  // after it is unknown. the last frame is not split yet.
+  //
+  ASSERT_EQ(clouds.size(), 5u);
+  for (const auto& cloud : clouds)
+  {
+    for (size_t src = 0; src < 2; src++)
+    {
+      const LidarSlice& slice = cloud->sources[src];
+      ASSERT_TRUE(slice.received);
+      ASSERT_GT(slice.size, 0u);
+      ASSERT_EQ((int64_t)std::floor(slice.timestamp / 0.1), (int64_t)std::floor(cloud->timestamp / 0.1 + 0.5));
+    }
+  }
+}
@@ -0,0 +1,172 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/api/packet_decoder.hpp>
+
+#include <thread>
+
+using namespace robosense::lidar;
+
+static void buildRS16MsopPkt(RS16MsopPkt& pkt, int32_t start_az)
+{
+  memset(&pkt, 0, sizeof(pkt));
+
+  uint8_t id[] = {0x55, 0xAA, 0x05, 0x0A, 0x5A, 0xA5, 0x50, 0xA0};
+  memcpy(pkt.header.id, id, sizeof(id));
+
+  for (uint16_t blk = 0; blk < 12; blk++)
+  {
+    RS16MsopBlock& block = pkt.blocks[blk];
+    block.id[0] = 0xFF;
+    block.id[1] = 0xEE;
+    block.azimuth = htons((uint16_t)((start_az + blk * 20) % 36000));
+
+    for (uint16_t chan = 0; chan < 32; chan++)
+    {
+      block.channels[chan].distance = htons(200); // 1m
+      block.channels[chan].intensity = 10;
+    }
+  }
+}
+
+class TestPacketDecoder : public ::testing::Test
+{
+protected:
+
+  TestPacketDecoder()
+    : calib_(LidarType::RS16, createParam())
+  {
+    out_.xs.bind(xs_, CAPACITY);
+    out_.ys.bind(ys_, CAPACITY);
+    out_.zs.bind(zs_, CAPACITY);
+    out_.timestamps.bind(tss_, CAPACITY);
+  }
+
+  static RSDecoderParam createParam()
+  {
+    RSDecoderParam param;
+    param.wait_for_difop = false;
+    param.sector_pkts = 4;
+    return param;
+  }
+
+  constexpr static size_t CAPACITY = 1000;
+
+  CalibrationState calib_;
+  OutputSpan out_;
+  float xs_[CAPACITY];
+  float ys_[CAPACITY];
+  float zs_[CAPACITY];
+  double tss_[CAPACITY];
+};
+
+TEST_F(TestPacketDecoder, CalibrationState)
+{
+  ASSERT_EQ(calib_.param().sector_pkts, 0);
+
+  uint64_t id = calib_.id();
+  uint8_t difop[] = {0x01, 0x02};
+  calib_.updateDifop(difop, sizeof(difop));
+  ASSERT_EQ(calib_.difop().size(), 2u);
+  ASSERT_NE(calib_.id(), id);
+}
+
+TEST_F(TestPacketDecoder, decode)
+{
+  RS16MsopPkt pkt;
+  buildRS16MsopPkt(pkt, 35800);
+
+  // split at the 11th block
+  ASSERT_TRUE(decode((const uint8_t*)&pkt, sizeof(pkt), calib_, out_));
+  ASSERT_EQ(out_.error, ERRCODE_SUCCESS);
+  ASSERT_EQ(out_.size(), 384u);
+  ASSERT_EQ(out_.split_index, 320u);
+  ASSERT_EQ(out_.ys.size(), 384u);
+  ASSERT_EQ(out_.intensities.size(), 0u);
+
+  // no split. points are appended.
+  buildRS16MsopPkt(pkt, 100);
+  ASSERT_FALSE(decode((const uint8_t*)&pkt, sizeof(pkt), calib_, out_));
+  ASSERT_FALSE(out_.split);
+  ASSERT_EQ(out_.size(), 768u);
+
+  // split at the first block, whatever the previous packet is
+  out_.clear();
+  buildRS16MsopPkt(pkt, 0);
+  ASSERT_TRUE(decode((const uint8_t*)&pkt, sizeof(pkt), calib_, out_));
+  ASSERT_EQ(out_.split_index, 0u);
+}
+
+TEST_F(TestPacketDecoder, decode_error)
+{
+  RS16MsopPkt pkt;
+  buildRS16MsopPkt(pkt, 0);
+
+  // wrong length
+  ASSERT_FALSE(decode((const uint8_t*)&pkt, sizeof(pkt) - 1, calib_, out_));
+  ASSERT_EQ(out_.error, ERRCODE_WRONGMSOPLEN);
+  ASSERT_EQ(out_.size(), 0u);
+
+  // overflow
+  out_.xs.bind(xs_, 100);
+  ASSERT_TRUE(decode((const uint8_t*)&pkt, sizeof(pkt), calib_, out_));
+  ASSERT_EQ(out_.error, ERRCODE_CLOUDOVERFLOW);
+  ASSERT_EQ(out_.size(), 100u);
+}
+
+TEST_F(TestPacketDecoder, decode_threads)
+{
+  RS16MsopPkt pkt;
+  buildRS16MsopPkt(pkt, 35800);
+
+  size_t split_index[2] = {0};
+  size_t size[2] = {0};
+
+  auto run = [&](int i)
+  {
+    float xs[CAPACITY];
+    OutputSpan out;
+    out.xs.bind(xs, CAPACITY);
+
+    for (int n = 0; n < 10; n++)
+    {
+      out.clear();
+      decode((const uint8_t*)&pkt, sizeof(pkt), calib_, out);
+    }
+
+    split_index[i] = out.split_index;
+    size[i] = out.size();
+  };
+
+  std::thread t0(run, 0);
+  std::thread t1(run, 1);
+  t0.join();
+  t1.join();
+
+  ASSERT_EQ(split_index[0], 320u);
+  ASSERT_EQ(split_index[1], 320u);
+  ASSERT_EQ(size[0], 384u);
+  ASSERT_EQ(size[1], 384u);
+}
+
+TEST_F(TestPacketDecoder, decode_statefulSplit)
+{
+  ASSERT_TRUE(calib_.splits());
+
+  // blocks are counted across packets. no split hint.
+  RSDecoderParam param = createParam();
+  param.split_frame_mode = SplitFrameMode::SPLIT_BY_FIXED_BLKS;
+  CalibrationState calib(LidarType::RS16, param);
+  ASSERT_FALSE(calib.splits());
+
+  RS16MsopPkt pkt;
+  buildRS16MsopPkt(pkt, 35800);
+  ASSERT_FALSE(decode((const uint8_t*)&pkt, sizeof(pkt), calib, out_));
+  ASSERT_FALSE(out_.split);
+  ASSERT_EQ(out_.error, ERRCODE_SUCCESS);
+  ASSERT_EQ(out_.size(), 384u);
+
+  // packet seqs of M-series lidars
+  CalibrationState calib_m1(LidarType::RSM1, createParam());
+  ASSERT_FALSE(calib_m1.splits());
+}
@@ -0,0 +1,228 @@
+#ifndef DISABLE_PCAP_PARSE
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/api/pcap_frame_reader.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+#include <rs_driver/driver/decoder/decoder_RS16.hpp>
+
+#include <cstdio>
+
+using namespace robosense::lidar;
+
+typedef PointCloudT<PointXYZI> PointCloud;
+
+static const char* PCAP_PATH = "pcap_frame_reader_test.pcap";
+static const uint64_t PKT_USEC = 1000000000000000; // capture time of the first packet, in us
+
+//
+// a PCAP file of UDP packets, written in the native byte order, with the Ethernet link type.
+//
+class PcapFile
+{
+public:
+
+  PcapFile()
+    : fp_(fopen(PCAP_PATH, "wb")), ip_id_(1)
+  {
+    uint32_t gh[6] = {0xa1b2c3d4, 0x00040002, 0, 0, 65535, 1};
+    fwrite(gh, sizeof(gh), 1, fp_);
+  }
+
+  ~PcapFile()
+  {
+    close();
+    remove(PCAP_PATH);
+  }
+
+  void close()
+  {
+    if (fp_ != NULL)
+    {
+      fclose(fp_);
+      fp_ = NULL;
+    }
+  }
+
+  void write(uint16_t dst_port, const uint8_t* data, size_t size)
+  {
+    uint8_t hdr[42] =
+    {
+      0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00, 0x1c, 0x23, 0x17, 0x4a, 0xcb, 0x08, 0x00, // ethernet
+      0x45, 0x00, 0x00, 0x00, 0x00, 0x00, 0x40, 0x00, 0x40, 0x11, 0x00, 0x00,           // ip
+      192, 168, 1, 200, 192, 168, 1, 102,
+      0x1a, 0x2b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00                                    // udp
+    };
+
+    uint16_t ip_len = (uint16_t)(20 + 8 + size);
+    hdr[16] = ip_len >> 8;
+    hdr[17] = ip_len & 0xff;
+    hdr[18] = ip_id_ >> 8;
+    hdr[19] = ip_id_ & 0xff;
+    hdr[36] = dst_port >> 8;
+    hdr[37] = dst_port & 0xff;
+    hdr[38] = (ip_len - 20) >> 8;
+    hdr[39] = (ip_len - 20) & 0xff;
+    ip_id_++;
+
+    uint32_t len = (uint32_t)(sizeof(hdr) + size);
+    uint32_t rh[4] = {0, 0, len, len};
+    fwrite(rh, sizeof(rh), 1, fp_);
+    fwrite(hdr, sizeof(hdr), 1, fp_);
+    fwrite(data, size, 1, fp_);
+  }
+
+private:
+
+  FILE* fp_;
+  uint16_t ip_id_;
+};
+
+//
+// a RS16 MSOP packet, whose blocks start at the azimuth az, and step by 20 (0.2 degree).
+//
+static void makeMsopPkt(RS16MsopPkt& pkt, uint16_t az, uint64_t usec)
+{
+  memset(&pkt, 0, sizeof(pkt));
+
+  const uint8_t msop_id[] = {0x55, 0xAA, 0x05, 0x0A, 0x5A, 0xA5, 0x50, 0xA0};
+  memcpy(&pkt.header, msop_id, sizeof(msop_id));
+  createTimeYMD(usec, &pkt.header.timestamp);
+
+  for (uint16_t blk = 0; blk < 12; blk++)
+  {
+    RS16MsopBlock& block = pkt.blocks[blk];
+    block.id[0] = 0xFF;
+    block.id[1] = 0xEE;
+    block.azimuth = htons(az + blk * 20);
+
+    for (uint16_t chan = 0; chan < 32; chan++)
+    {
+      block.channels[chan].distance = htons(1000); // 5 m
+      block.channels[chan].intensity = 10;
+    }
+  }
+}
+
+template <typename T_Input>
+static void readInputFile(size_t pkt_size)
+{
+  PcapFile file;
+  uint8_t msop[1248] = {0x55, 0xAA, 1};
+  uint8_t difop[1248] = {0xA5, 0xFF, 2};
+  uint8_t other[100] = {0x55, 0xAA, 3};
+
+  file.write(6699, msop, sizeof(msop));
+  file.write(1234, other, sizeof(other)); // filtered out
+  file.write(7788, difop, sizeof(difop));
+  file.write(6699, msop, sizeof(msop));
+  file.close();
+
+  RSInputParam param;
+  param.pcap_path = PCAP_PATH;
+  param.msop_port = 6699;
+  param.difop_port = 7788;
+
+  std::vector<std::shared_ptr<Buffer>> pkts;
+  T_Input input(param, 0.0);
+  input.regCallback(
+      [](const Error& err) {},
+      [pkt_size](size_t size) -> std::shared_ptr<Buffer> {
+        EXPECT_EQ(size, pkt_size);
+        return std::make_shared<Buffer>(size);
+      },
+      [&pkts](std::shared_ptr<Buffer> pkt, bool) { pkts.push_back(pkt); });
+  ASSERT_TRUE(input.init());
+
+  while (input.readPacket())
+    ;
+
+  ASSERT_EQ(pkts.size(), 3);
+  ASSERT_EQ(pkts[0]->dataSize(), 1248);
+  ASSERT_EQ(pkts[0]->data()[2], 1);
+  ASSERT_EQ(pkts[1]->data()[2], 2);
+  ASSERT_EQ(pkts[2]->data()[2], 1);
+}
+
+TEST(TestInputPcap, readPacket)
+{
+  readInputFile<InputPcap>(ETH_LEN);
+}
+
+TEST(TestInputPcap, readPacketJumbo)
+{
+  readInputFile<InputPcapJumbo>(IP_LEN);
+}
+
+TEST(TestInputPcap, wrongPath)
+{
+  RSInputParam param;
+  param.pcap_path = "no_such_file.pcap";
+
+  ErrCode err_code = ERRCODE_SUCCESS;
+  InputPcap input(param, 0.0);
+  input.regCallback(
+      [&err_code](const Error& err) { err_code = err.error_code; },
+      [](size_t size) { return std::make_shared<Buffer>(size); },
+      [](std::shared_ptr<Buffer> pkt, bool) {});
+  ASSERT_FALSE(input.init());
+  ASSERT_EQ(err_code, ERRCODE_PCAPWRONGPATH);
+}
+
+TEST(TestPcapFrameReader, next)
+{
+  PcapFile file;
+
+  // the frame is split between the first and the second packet, where the azimuth crosses 0.
+  RS16MsopPkt pkt;
+  makeMsopPkt(pkt, 35000, PKT_USEC);
+  file.write(6699, (const uint8_t*)&pkt, sizeof(pkt));
+  makeMsopPkt(pkt, 100, PKT_USEC + 1000);
+  file.write(6699, (const uint8_t*)&pkt, sizeof(pkt));
+  makeMsopPkt(pkt, 1000, PKT_USEC + 2000);
+  file.write(6699, (const uint8_t*)&pkt, sizeof(pkt));
+  file.close();
+
+  RSDriverParam param;
+  param.lidar_type = LidarType::RS16;
+  param.decoder_param.wait_for_difop = false;
+  param.decoder_param.use_lidar_clock = false;
+
+  PcapFrameReader<PointCloud> reader(PCAP_PATH, param);
+  ASSERT_TRUE(reader.driver_param_.decoder_param.use_lidar_clock);
+
+  std::vector<ErrCode> errs;
+  reader.regExceptionCallback([&errs](const Error& err) { errs.push_back(err.error_code); });
+
+  PointCloud cloud;
+  ASSERT_TRUE(reader.next(cloud));
+  ASSERT_EQ(cloud.seq, 0);
+  ASSERT_EQ(cloud.points.size(), 12 * 32);
+  ASSERT_NEAR(cloud.timestamp, PKT_USEC * 1e-6, 0.01); // the lidar clock, not the host clock
+
+  // the last frame, at the end of file
+  ASSERT_TRUE(reader.next(cloud));
+  ASSERT_EQ(cloud.seq, 1);
+  ASSERT_EQ(cloud.points.size(), 2 * 12 * 32);
+  ASSERT_NEAR(cloud.timestamp, (PKT_USEC + 2000) * 1e-6, 0.01);
+
+  ASSERT_FALSE(reader.next(cloud));
+  ASSERT_EQ(errs.back(), ERRCODE_PCAPEXIT);
+}
+
+TEST(TestPcapFrameReader, wrongPath)
+{
+  RSDriverParam param;
+  param.lidar_type = LidarType::RS16;
+
+  PcapFrameReader<PointCloud> reader("no_such_file.pcap", param);
+
+  ErrCode err_code = ERRCODE_SUCCESS;
+  reader.regExceptionCallback([&err_code](const Error& err) { err_code = err.error_code; });
+
+  PointCloud cloud;
+  ASSERT_FALSE(reader.next(cloud));
+  ASSERT_EQ(err_code, ERRCODE_PCAPWRONGPATH);
+}
+
+#endif
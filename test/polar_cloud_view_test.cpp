@@ -0,0 +1,108 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/utility/polar_cloud_view.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+
+using namespace robosense::lidar;
+
+static void pushPolar(PolarPointCloud& cloud, float distance, int32_t azimuth, int32_t elevation, 
+    uint16_t ring, uint8_t intensity, float ts_offset)
+{
+  cloud.distances.push_back(distance);
+  cloud.azimuths.push_back(azimuth);
+  cloud.elevations.push_back(elevation);
+  cloud.rings.push_back(ring);
+  cloud.intensities.push_back(intensity);
+  cloud.ts_offsets.push_back(ts_offset);
+}
+
+TEST(TestPolarCloudView, xyzAt)
+{
+  PolarPointCloud cloud;
+  cloud.ts_base = 10.0;
+  pushPolar(cloud, 2.0f, 0, 0, 0, 10, 0.0f);
+  pushPolar(cloud, 2.0f, 9000, 0, 1, 20, 0.5f);
+  pushPolar(cloud, 2.0f, 0, 9000, 2, 30, 0.0f);
+  pushPolar(cloud, 0.0f, 0, 0, 3, 0, 0.0f);
+
+  PolarCloudView view(cloud);
+  ASSERT_EQ(view.size(), 4);
+
+  float x, y, z;
+  view.xyzAt(0, x, y, z);
+  ASSERT_NEAR(x, 2.0f, 1e-5);
+  ASSERT_NEAR(y, 0.0f, 1e-5);
+  ASSERT_NEAR(z, 0.0f, 1e-5);
+
+  // clockwise azimuth
+  view.xyzAt(1, x, y, z);
+  ASSERT_NEAR(x, 0.0f, 1e-5);
+  ASSERT_NEAR(y, -2.0f, 1e-5);
+  ASSERT_EQ(view.timestampAt(1), 10.5);
+
+  view.xyzAt(2, x, y, z);
+  ASSERT_NEAR(z, 2.0f, 1e-5);
+
+  ASSERT_FALSE(view.valid(3));
+  view.xyzAt(3, x, y, z);
+  ASSERT_TRUE(std::isnan(x));
+
+  // optical center and transform
+  cloud.rx = 0.1f;
+  cloud.rz = 0.2f;
+  RSTransformParam transform_param;
+  transform_param.x = 1.0f;
+  PolarCloudView view2(cloud, transform_param);
+  view2.xyzAt(0, x, y, z);
+  ASSERT_NEAR(x, 3.1f, 1e-5);
+  ASSERT_NEAR(z, 0.2f, 1e-5);
+}
+
+TEST(TestPolarCloudView, angleUnknown)
+{
+  // RSE1/RSM2 give distances only
+  PolarPointCloud cloud;
+  pushPolar(cloud, 2.0f, PointBatch::ANGLE_UNKNOWN, PointBatch::ANGLE_UNKNOWN, 0, 10, 0.0f);
+
+  PolarCloudView view(cloud);
+  ASSERT_FALSE(view.valid(0));
+
+  float x, y, z;
+  view.xyzAt(0, x, y, z);
+  ASSERT_TRUE(std::isnan(x));
+  ASSERT_TRUE(std::isnan(y));
+  ASSERT_TRUE(std::isnan(z));
+}
+
+TEST(TestPolarCloudView, toPointCloud)
+{
+  PolarPointCloud cloud;
+  for (uint16_t i = 0; i < 100; i++)
+  {
+    pushPolar(cloud, (float)(i + 1), 0, 0, i, (uint8_t)i, 0.0f);
+  }
+
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < 100; i += 3)
+  {
+    indices.push_back(i);
+  }
+
+  PolarCloudView view(cloud);
+
+  PointCloudT<PointXYZIRT> out;
+  view.toPointCloud(indices, out);
+  ASSERT_EQ(out.points.size(), indices.size());
+  ASSERT_NEAR(out.points[2].x, 7.0f, 1e-5);
+  ASSERT_EQ(out.points[2].ring, 6);
+
+  PointCloudT<PointXYZIRT> out4;
+  view.toPointCloud(indices, out4, 4);
+  ASSERT_EQ(out4.points.size(), indices.size());
+  for (size_t i = 0; i < indices.size(); i++)
+  {
+    ASSERT_EQ(out4.points[i].x, out.points[i].x);
+    ASSERT_EQ(out4.points[i].ring, indices[i]);
+  }
+}
@@ -0,0 +1,66 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/roi_filter.hpp>
+
+using namespace robosense::lidar;
+
+TEST(TestRoiFilter, mask)
+{
+  RSRingAzimuthMask mask;
+  mask.azimuth_bins = 4; // 90 degree per bin
+  mask.masked = {0, 1, 0, 0,   // ring 0, (90, 180) masked
+                 0, 0, 0, 1};  // ring 1, (270, 360) masked
+
+  RoiFilter roi(std::vector<RSCropBox>(), mask);
+  ASSERT_TRUE(roi.hasMask());
+  ASSERT_FALSE(roi.hasBoxes(false));
+
+  ASSERT_FALSE(roi.masked(0, 1000));
+  ASSERT_TRUE(roi.masked(0, 10000));
+  ASSERT_FALSE(roi.masked(1, 1000));
+  ASSERT_TRUE(roi.masked(1, -1000)); // negative azimuth, i.e. 350 degree
+  ASSERT_TRUE(roi.masked(1, 36000 + 35000));
+  ASSERT_FALSE(roi.masked(2, 10000)); // ring out of the mask
+
+  RoiFilter none({}, RSRingAzimuthMask());
+  ASSERT_FALSE(none.hasMask());
+  ASSERT_FALSE(none.masked(0, 10000));
+}
+
+TEST(TestRoiFilter, boxes)
+{
+  RSCropBox include;
+  include.length = 20.0f;
+  include.width = 20.0f;
+  include.height = 4.0f;
+
+  RSCropBox exclude; // oriented box around (5, 0)
+  exclude.x = 5.0f;
+  exclude.length = 2.0f;
+  exclude.width = 0.2f;
+  exclude.height = 4.0f;
+  exclude.yaw = M_PI / 2;
+  exclude.include = false;
+
+  RSCropBox other; // transformed frame
+  other.transformed = true;
+
+  RoiFilter roi({include, exclude, other}, RSRingAzimuthMask());
+  ASSERT_FALSE(roi.hasMask());
+  ASSERT_TRUE(roi.hasBoxes(false));
+  ASSERT_TRUE(roi.hasBoxes(true));
+
+  float xs[] = {1.0f, 11.0f, 5.0f, 5.0f, NAN};
+  float ys[] = {1.0f, 0.0f, 0.9f, -0.5f, NAN};
+  float zs[] = {0.0f, 0.0f, 0.0f, 0.0f, NAN};
+  uint8_t intensities[] = {1, 1, 1, 1, 0};
+  float distances[] = {1.0f, 1.0f, 1.0f, 1.0f, 0.0f};
+  roi.applyBoxes(false, xs, ys, zs, intensities, distances, 5);
+
+  ASSERT_FALSE(std::isnan(xs[0]));
+  ASSERT_TRUE(std::isnan(xs[1])); // out of the include box
+  ASSERT_TRUE(std::isnan(xs[2])); // inside the rotated exclude box
+  ASSERT_TRUE(std::isnan(xs[3]));
+  ASSERT_TRUE(std::isnan(xs[4]));
+}
@@ -8,6 +8,7 @@ using namespace robosense::lidar;
 TEST(TestAzimuthSection, ctorFull)
 {
   AzimuthSection sec(0, 36000);
+  ASSERT_TRUE(sec.fullRound());
   ASSERT_TRUE(sec.in(0));
   ASSERT_TRUE(sec.in(10));
   ASSERT_TRUE(sec.in(36000));
@@ -16,6 +17,7 @@ TEST(TestAzimuthSection, ctorFull)
 TEST(TestAzimuthSection, ctor)
 {
   AzimuthSection sec(10, 20);
+  ASSERT_FALSE(sec.fullRound());
   ASSERT_EQ(sec.start_, 10);
   ASSERT_EQ(sec.end_, 20);
 
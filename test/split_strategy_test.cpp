@@ -9,21 +9,21 @@ TEST(TestSplitStrategyByAngle, newBlock)
 {
   {
     SplitStrategyByAngle sa(10);
-    ASSERT_FALSE(sa.newBlock(5));
-    ASSERT_TRUE(sa.newBlock(15));
+    ASSERT_FALSE(sa.newBlock(5, 0.0));
+    ASSERT_TRUE(sa.newBlock(15, 0.0));
   }
 
   {
     SplitStrategyByAngle sa(10);
-    ASSERT_FALSE(sa.newBlock(5));
-    ASSERT_TRUE(sa.newBlock(10));
-    ASSERT_FALSE(sa.newBlock(15));
+    ASSERT_FALSE(sa.newBlock(5, 0.0));
+    ASSERT_TRUE(sa.newBlock(10, 0.0));
+    ASSERT_FALSE(sa.newBlock(15, 0.0));
   }
 
   {
     SplitStrategyByAngle sa(10);
-    ASSERT_FALSE(sa.newBlock(10));
-    ASSERT_FALSE(sa.newBlock(15));
+    ASSERT_FALSE(sa.newBlock(10, 0.0));
+    ASSERT_FALSE(sa.newBlock(15, 0.0));
   }
 }
 
@@ -31,38 +31,97 @@ TEST(TestSplitStrategyByAngle, newBlock_Zero)
 {
   {
     SplitStrategyByAngle sa(0);
-    ASSERT_FALSE(sa.newBlock(35999));
-    ASSERT_TRUE(sa.newBlock(1));
-    ASSERT_FALSE(sa.newBlock(2));
+    ASSERT_FALSE(sa.newBlock(35999, 0.0));
+    ASSERT_TRUE(sa.newBlock(1, 0.0));
+    ASSERT_FALSE(sa.newBlock(2, 0.0));
   }
 
   {
     SplitStrategyByAngle sa(0);
-    ASSERT_FALSE(sa.newBlock(35999));
-    ASSERT_TRUE(sa.newBlock(0));
-    ASSERT_FALSE(sa.newBlock(2));
+    ASSERT_FALSE(sa.newBlock(35999, 0.0));
+    ASSERT_TRUE(sa.newBlock(0, 0.0));
+    ASSERT_FALSE(sa.newBlock(2, 0.0));
   }
 
   {
     SplitStrategyByAngle sa(0);
-    ASSERT_FALSE(sa.newBlock(0));
-    ASSERT_FALSE(sa.newBlock(2));
+    ASSERT_FALSE(sa.newBlock(0, 0.0));
+    ASSERT_FALSE(sa.newBlock(2, 0.0));
+  }
+}
+
+TEST(TestSplitStrategyByAngle, reset)
+{
+  {
+    SplitStrategyByAngle sa(0);
+    ASSERT_FALSE(sa.newBlock(35000, 0.0));
+    sa.reset(20);
+    ASSERT_TRUE(sa.newBlock(10, 0.0));
+    ASSERT_FALSE(sa.newBlock(30, 0.0));
+  }
+
+  {
+    SplitStrategyByAngle sa(0);
+    ASSERT_FALSE(sa.newBlock(35990, 0.0));
+    sa.reset(20);
+    ASSERT_FALSE(sa.newBlock(100, 0.0));
+    ASSERT_FALSE(sa.newBlock(120, 0.0));
+  }
+
+  {
+    SplitStrategyByAngle sa(35990);
+    sa.reset(20);
+    ASSERT_TRUE(sa.newBlock(35995, 0.0));
+    sa.reset(20);
+    ASSERT_FALSE(sa.newBlock(5, 0.0));
+    ASSERT_FALSE(sa.newBlock(25, 0.0));
   }
 }
 
 TEST(TestSplitStrategyByNum, newBlock)
 {
-  uint16_t max_blks = 2;
-  SplitStrategyByNum sn(&max_blks);
-  ASSERT_FALSE(sn.newBlock(0));
-  ASSERT_TRUE(sn.newBlock(0));
-  ASSERT_FALSE(sn.newBlock(0));
-  ASSERT_TRUE(sn.newBlock(0));
-
-  max_blks = 3;
-  ASSERT_FALSE(sn.newBlock(0));
-  ASSERT_FALSE(sn.newBlock(0));
-  ASSERT_TRUE(sn.newBlock(0));
+  SplitStrategyByNum sn(2);
+  ASSERT_FALSE(sn.newBlock(0, 0.0));
+  ASSERT_TRUE(sn.newBlock(0, 0.0));
+  ASSERT_FALSE(sn.newBlock(0, 0.0));
+  ASSERT_TRUE(sn.newBlock(0, 0.0));
+
+  sn.setMaxBlks(3);
+  ASSERT_FALSE(sn.newBlock(0, 0.0));
+  ASSERT_FALSE(sn.newBlock(0, 0.0));
+  ASSERT_TRUE(sn.newBlock(0, 0.0));
+}
+
+TEST(TestSplitStrategyByTime, newBlock)
+{
+  SplitStrategyByTime st(0.1);
+  ASSERT_FALSE(st.newBlock(0, 1000.05));
+  ASSERT_FALSE(st.newBlock(0, 1000.09));
+  ASSERT_TRUE(st.newBlock(0, 1000.1001));
+  ASSERT_FALSE(st.newBlock(0, 1000.15));
+
+  // skip a window
+  ASSERT_TRUE(st.newBlock(0, 1000.35));
+
+  // time goes back a little. ignored.
+  ASSERT_FALSE(st.newBlock(0, 1000.25));
+  ASSERT_FALSE(st.newBlock(0, 1000.39));
+  ASSERT_TRUE(st.newBlock(0, 1000.41));
+
+  // time goes back far, i.e. rewinds.
+  ASSERT_TRUE(st.newBlock(0, 999.05));
+  ASSERT_FALSE(st.newBlock(0, 999.09));
+}
+
+TEST(TestSplitStrategyByTime, newTime_aligned)
+{
+  // frames of two lidars cover the same windows.
+  SplitStrategyByTime st1(0.1);
+  SplitStrategyByTime st2(0.1);
+  ASSERT_FALSE(st1.newTime(1700000000.01));
+  ASSERT_FALSE(st2.newTime(1700000000.07));
+  ASSERT_TRUE(st1.newTime(1700000000.1002));
+  ASSERT_TRUE(st2.newTime(1700000000.1005));
 }
 
 TEST(TestSplitStrategyBySeq, newPacket_by_seq)
@@ -0,0 +1,55 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/transform.hpp>
+
+using namespace robosense::lidar;
+
+TEST(TestTransform, identity)
+{
+  RSTransformParam param;
+  Transform trans(param);
+  ASSERT_TRUE(trans.isIdentity());
+
+  param.yaw = 0.1f;
+  Transform trans2(param);
+  ASSERT_FALSE(trans2.isIdentity());
+}
+
+TEST(TestTransform, apply)
+{
+  RSTransformParam param;
+  param.x = 1.0f;
+  param.z = 2.0f;
+  param.yaw = (float)(M_PI / 2);
+  Transform trans(param);
+
+  float x = 1.0f, y = 0.0f, z = 0.0f;
+  trans.apply(x, y, z);
+  ASSERT_NEAR(x, 1.0f, 0.0001f);
+  ASSERT_NEAR(y, 1.0f, 0.0001f);
+  ASSERT_NEAR(z, 2.0f, 0.0001f);
+}
+
+TEST(TestTransform, apply_batch)
+{
+  RSTransformParam param;
+  param.y = -1.0f;
+  param.roll = (float)(M_PI / 2);
+  Transform trans(param);
+
+  float xs[] = {0.0f, 1.0f, NAN};
+  float ys[] = {1.0f, 0.0f, NAN};
+  float zs[] = {0.0f, 0.0f, NAN};
+  trans.apply(xs, ys, zs, 3);
+
+  ASSERT_NEAR(xs[0], 0.0f, 0.0001f);
+  ASSERT_NEAR(ys[0], -1.0f, 0.0001f);
+  ASSERT_NEAR(zs[0], 1.0f, 0.0001f);
+
+  ASSERT_NEAR(xs[1], 1.0f, 0.0001f);
+  ASSERT_NEAR(ys[1], -1.0f, 0.0001f);
+  ASSERT_NEAR(zs[1], 0.0f, 0.0001f);
+
+  ASSERT_TRUE(std::isnan(xs[2]));
+}
@@ -0,0 +1,89 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <rs_driver/driver/decoder/trigon.hpp>
+
+using namespace robosense::lidar;
+
+// other data written per block, such as points, which competes for the cache.
+static std::vector<uint8_t> other_data;
+static size_t other_pos = 0;
+
+static void touchOtherData(size_t bytes)
+{
+  for (size_t i = 0; i < bytes; i += 64)
+  {
+    other_data[other_pos] += 1;
+    other_pos = (other_pos + 64) % other_data.size();
+  }
+}
+
+//
+// angles are visited as a mechanical lidar does, i.e. azimuth of each block,
+// and vertical angles of its channels.
+//
+template <typename T_Trigon>
+double bench(T_Trigon& trigon, const std::vector<int32_t>& vert_angles, 
+    uint32_t rounds, size_t other_bytes, float& sum)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  for (uint32_t r = 0; r < rounds; r++)
+  {
+    for (int32_t azi = 0; azi < 36000; azi += 20)
+    {
+      for (auto vert : vert_angles)
+      {
+        sum += trigon.cos(vert) * trigon.cos(azi + r) - trigon.sin(vert) * trigon.sin(azi + r);
+      }
+
+      touchOtherData(other_bytes);
+    }
+  }
+
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+
+  return ns / (rounds * 1800 * vert_angles.size() * 4);
+}
+
+//
+// usage: rs_driver_benchmark [bytes of other data per block]
+//
+// With the default 0, the tables compete with nothing, and the time is about lookup only. 
+// Give a size (e.g. 4096) to emulate cache pressure of decoding on the target CPU. 
+//
+int main(int argc, char* argv[])
+{
+  size_t other_bytes = (argc > 1) ? (size_t)std::stoul(argv[1]) : 0;
+  other_data.resize(8 * 1024 * 1024);
+
+  std::vector<int32_t> vert_angles;
+  for (int32_t i = 0; i < 128; i++)
+  {
+    vert_angles.push_back(-2500 + i * 40);
+  }
+
+  uint32_t rounds = 100;
+  float sum = 0.0f;
+
+  Trigon trigon;
+  TrigonCompact compact;
+
+  // warm up
+  bench(trigon, vert_angles, 1, other_bytes, sum);
+  bench(compact, vert_angles, 1, other_bytes, sum);
+
+  double t1 = bench(trigon, vert_angles, rounds, other_bytes, sum);
+  double t2 = bench(compact, vert_angles, rounds, other_bytes, sum);
+
+  std::cout << "Trigon        : " << t1 << " ns/lookup, table " 
+    << (Trigon::ANGLE_MAX - Trigon::ANGLE_MIN) * 2 * sizeof(float) << " bytes" << std::endl;
+  std::cout << "TrigonCompact : " << t2 << " ns/lookup, table " 
+    << sizeof(TrigonCompact) << " bytes" << std::endl;
+  std::cout << "(checksum " << sum << ")" << std::endl;
+
+  return 0;
+}
@@ -30,3 +30,42 @@ TEST(TestTrigon, ctor)
 #endif
 }
 
+
+TEST(TestTrigonCompact, ctor)
+{
+  TrigonCompact trigon;
+
+  ASSERT_EQ(trigon.sin(-9000), -1.0f);
+  ASSERT_LT(trigon.cos(-9000), 0.0001f);
+
+  ASSERT_EQ(trigon.sin(0), 0.0f);
+  ASSERT_EQ(trigon.cos(0), 1.0f);
+
+  ASSERT_EQ(trigon.sin(3000), 0.5f);
+  ASSERT_EQ(trigon.cos(6000), 0.5f);
+
+  ASSERT_EQ(trigon.sin(45000), 0.0f);
+  ASSERT_EQ(trigon.cos(45000), 1.0f);
+}
+
+TEST(TestTrigonCompact, accuracy)
+{
+  Trigon trigon;
+  TrigonCompact compact;
+
+  for (int32_t i = Trigon::ANGLE_MIN; i < Trigon::ANGLE_MAX; i++)
+  {
+    ASSERT_NEAR(compact.sin(i), trigon.sin(i), 1e-6f) << "angle: " << i;
+    ASSERT_NEAR(compact.cos(i), trigon.cos(i), 1e-6f) << "angle: " << i;
+  }
+}
+
+TEST(TestTrigon, instance)
+{
+  const Trigon& t1 = Trigon::instance();
+  const Trigon& t2 = Trigon::instance();
+  ASSERT_EQ(&t1, &t2);
+  ASSERT_EQ(t1.sin(3000), 0.5f);
+
+  ASSERT_EQ(&TrigonCompact::instance(), &TrigonCompact::instance());
+}
@@ -0,0 +1,103 @@
+
+#include <gtest/gtest.h>
+
+#include <rs_driver/driver/decoder/voxel_grid.hpp>
+#include <rs_driver/msg/point_cloud_msg.hpp>
+
+using namespace robosense::lidar;
+
+typedef PointCloudT<PointXYZIRT> PointCloud;
+
+TEST(TestVoxelGrid, centroid)
+{
+  VoxelGrid grid(1.0f, true);
+
+  float xs[] = {0.2f, 0.4f, 1.5f, NAN, -0.5f};
+  float ys[] = {0.0f, 0.0f, 0.0f, NAN, 0.0f};
+  float zs[] = {0.0f, 0.0f, 0.0f, NAN, 0.0f};
+  uint8_t intensities[] = {10, 20, 30, 0, 40};
+  double tss[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+  uint16_t rings[] = {1, 2, 3, 4, 5};
+  grid.add(xs, ys, zs, intensities, tss, rings, 5);
+  ASSERT_EQ(grid.size(), 3);
+
+  PointCloud cloud;
+  grid.output(cloud);
+  ASSERT_EQ(grid.size(), 0);
+  ASSERT_EQ(cloud.points.size(), 3);
+
+  ASSERT_NEAR(cloud.points[0].x, 0.3f, 1e-6);
+  ASSERT_EQ(cloud.points[0].intensity, 15);
+  ASSERT_EQ(cloud.points[0].timestamp, 1.0);
+  ASSERT_EQ(cloud.points[0].ring, 1);
+  ASSERT_EQ(cloud.points[1].x, 1.5f);
+  ASSERT_EQ(cloud.points[2].x, -0.5f); // negative index
+}
+
+TEST(TestVoxelGrid, firstPoint)
+{
+  VoxelGrid grid(1.0f, false);
+
+  float xs[] = {0.2f, 0.4f};
+  float ys[] = {0.0f, 0.0f};
+  float zs[] = {0.0f, 0.0f};
+  uint8_t intensities[] = {10, 20};
+  double tss[] = {1.0, 2.0};
+  uint16_t rings[] = {1, 2};
+  grid.add(xs, ys, zs, intensities, tss, rings, 2);
+
+  PointCloud cloud;
+  grid.output(cloud);
+  ASSERT_EQ(cloud.points.size(), 1);
+  ASSERT_EQ(cloud.points[0].x, 0.2f);
+  ASSERT_EQ(cloud.points[0].intensity, 10);
+}
+
+TEST(TestVoxelGrid, growAndReuse)
+{
+  VoxelGrid grid(1.0f, true);
+
+  // more voxels than the initial slots, twice each
+  const size_t num = 3000;
+  std::vector<float> xs(num * 2), ys(num * 2, 0.5f), zs(num * 2, 0.5f);
+  std::vector<uint8_t> intensities(num * 2, 10);
+  std::vector<double> tss(num * 2, 1.0);
+  std::vector<uint16_t> rings(num * 2, 0);
+  for (size_t i = 0; i < num * 2; i++)
+  {
+    xs[i] = (float)(i % num) - 1500.0f + 0.25f;
+  }
+
+  for (int frame = 0; frame < 3; frame++)
+  {
+    grid.add(xs.data(), ys.data(), zs.data(), intensities.data(), tss.data(), rings.data(), num * 2);
+    ASSERT_EQ(grid.size(), num);
+
+    PointCloud cloud;
+    grid.output(cloud); // the next frame starts from an empty grid
+    ASSERT_EQ(cloud.points.size(), num);
+    ASSERT_EQ(cloud.points[0].x, -1499.75f);
+    ASSERT_EQ(cloud.points[num - 1].x, 1499.25f);
+  }
+}
+
+TEST(TestVoxelGrid, generationWrap)
+{
+  VoxelGrid grid(1.0f, true);
+
+  float xs[] = {0.2f};
+  float ys[] = {0.0f};
+  float zs[] = {0.0f};
+  uint8_t intensities[] = {10};
+  double tss[] = {1.0};
+  uint16_t rings[] = {1};
+  grid.add(xs, ys, zs, intensities, tss, rings, 1);
+
+  grid.gen_ = UINT32_MAX;
+  grid.clear();
+  ASSERT_EQ(grid.gen_, 1u);
+  ASSERT_EQ(grid.size(), 0u);
+
+  grid.add(xs, ys, zs, intensities, tss, rings, 1);
+  ASSERT_EQ(grid.size(), 1u);
+}